@@ -0,0 +1,28 @@
+#!/bin/sh
+# Parse and run time of "echo w1 w2 ... wN | wc -w" at growing word counts.
+# Time per word should stay flat if lexing and argv building are linear;
+# ok is "no" when wc sees the wrong count or a count costs more than
+# 3x the ns/word of the smallest one.
+# Usage: bench/argv_words.sh [counts]   (default "10000 100000 1000000",
+# or BENCH_ARGV_WORDS)
+
+SHELL_BIN=${SHELL_BIN:-./minishell}
+COUNTS=${1:-${BENCH_ARGV_WORDS:-"10000 100000 1000000"}}
+SCRIPT=${BENCH_DIR:-/tmp}/bleshell_bench_words
+
+printf "%-8s %10s %10s %6s\n" words seconds "ns/word" ok
+base=
+for n in $COUNTS; do
+	awk -v n="$n" 'BEGIN { printf "echo"; for (i = 1; i <= n; i++)
+		printf " w%d", i; print " | wc -w" }' > "$SCRIPT"
+	start=$(date +%s.%N)
+	out=$("$SHELL_BIN" < "$SCRIPT" 2>/dev/null)
+	end=$(date +%s.%N)
+	ns=$(echo "$start $end $n" | awk '{ printf "%d", ($2 - $1) * 1e9 / $3 }')
+	[ -z "$base" ] && base=$ns
+	ok=no
+	[ "$out" -eq "$n" ] 2>/dev/null && [ "$ns" -le $((base * 3)) ] && ok=yes
+	echo "$start $end $n $ns $ok" | awk \
+		'{ printf "%-8d %10.3f %10d %6s\n", $3, $2 - $1, $4, $5 }'
+done
+rm -f "$SCRIPT"
@@ -0,0 +1,27 @@
+#!/bin/sh
+# Commands per second when a script is fed through stdin (batch mode).
+# Usage: bench/batch.sh [count]   (default 100000, or BENCH_CMDS)
+
+SHELL_BIN=${SHELL_BIN:-./minishell}
+COUNT=${1:-${BENCH_CMDS:-100000}}
+SCRIPT=${BENCH_DIR:-/tmp}/bleshell_bench_script
+
+run()
+{
+	start=$(date +%s.%N)
+	"$@" >/dev/null 2>&1
+	end=$(date +%s.%N)
+	echo "$start $end $COUNT" | awk -v name="$NAME" \
+		'{ t = $2 - $1; printf "%-24s %10.3f %12.0f\n", name, t, $3 / t }'
+}
+
+awk -v n="$COUNT" 'BEGIN { for (i = 0; i < n; i++) print "echo line " i }' \
+	> "$SCRIPT"
+printf "%-24s %10s %12s\n" input seconds "cmds/s"
+NAME="stdin (file)"
+run "$SHELL_BIN" < "$SCRIPT"
+NAME="stdin (pipe)"
+run sh -c "cat '$SCRIPT' | '$SHELL_BIN'"
+NAME="script argument"
+run "$SHELL_BIN" "$SCRIPT"
+rm -f "$SCRIPT"
@@ -0,0 +1,36 @@
+#!/bin/sh
+# Throughput of the cat/tee builtins against coreutils.
+# Usage: bench/cat_tee.sh [bytes]   (default 2G, or BENCH_BYTES)
+
+SHELL_BIN=${SHELL_BIN:-./minishell}
+BYTES=${1:-${BENCH_BYTES:-2147483648}}
+DIR=${BENCH_DIR:-/tmp}
+SRC=$DIR/bleshell_bench_src
+CAT=$(command -v cat)
+TEE=$(command -v tee)
+
+run()
+{
+	start=$(date +%s.%N)
+	echo "$2" | "$SHELL_BIN" >/dev/null 2>&1
+	end=$(date +%s.%N)
+	echo "$start $end $BYTES" | awk -v name="$1" \
+		'{ t = $2 - $1; printf "%-28s %10.3f %10.1f\n", name, t, $3 / t / 1048576 }'
+}
+
+head -c "$BYTES" /dev/urandom > "$SRC"
+printf "%-28s %10s %10s\n" case seconds "MB/s"
+for impl in builtin coreutils; do
+	c=cat
+	t=tee
+	if [ "$impl" = coreutils ]; then
+		c=$CAT
+		t=$TEE
+	fi
+	run "$impl file->pipe" "$c $SRC | wc -c"
+	run "$impl file->file" "$c $SRC > $DIR/bleshell_bench_out"
+	run "$impl pipe->pipe" "$CAT $SRC | $c | wc -c"
+	run "$impl tee pipe->pipe+file" \
+		"$CAT $SRC | $t $DIR/bleshell_bench_out | wc -c"
+done
+rm -f "$SRC" "$DIR/bleshell_bench_out"
@@ -0,0 +1,49 @@
+#!/bin/sh
+# Startup time of "bleshell -c exit" with growing inherited environments.
+# Passing a large environment through exec() costs every program, so
+# /bin/true is timed with the same environment and "shell ms" is what
+# bleshell adds on top of it. Each extra variable is about 40 bytes;
+# times are means over RUNS starts. ok is "no" when the shell's own
+# time grows by more than 0.25 ms per 1000 variables (plus 0.2 ms of
+# slack for timing noise).
+# Usage: bench/env_startup.sh [var counts]   (default
+# "50 1000 5000 20000", or BENCH_ENV_VARS; BENCH_ENV_RUNS starts per
+# size, default 50)
+
+SHELL_BIN=${SHELL_BIN:-./minishell}
+COUNTS=${1:-${BENCH_ENV_VARS:-"50 1000 5000 20000"}}
+RUNS=${BENCH_ENV_RUNS:-50}
+
+# Runs a program RUNS times, prints the elapsed seconds.
+starts()
+{
+	start=$(date +%s.%N)
+	r=0
+	while [ "$r" -lt "$RUNS" ]; do
+		"$@" -c exit > /dev/null 2>&1
+		r=$((r + 1))
+	done
+	end=$(date +%s.%N)
+	echo "$start $end" | awk '{ print $2 - $1 }'
+}
+
+printf "%-8s %10s %10s %10s %6s\n" vars "ms/start" "true ms" "shell ms" ok
+base=
+for n in $COUNTS; do
+	(
+		i=0
+		while [ "$i" -lt "$n" ]; do
+			export "BLESHELL_BENCH_VAR_$i=value_of_variable_$i"
+			i=$((i + 1))
+		done
+		echo "$n $(starts "$SHELL_BIN") $(starts /bin/true)"
+	)
+done | while read -r n shell_s true_s; do
+	us=$(echo "$shell_s $true_s $RUNS" | awk '{ printf "%d", ($1 - $2) * 1e6 / $3 }')
+	[ -z "$base" ] && base=$us && base_n=$n
+	ok=no
+	[ $((us - base)) -le $(((n - base_n) / 4 + 200)) ] && ok=yes
+	echo "$n $shell_s $true_s $RUNS $us $ok" | awk '{ printf \
+		"%-8d %10.3f %10.3f %10.3f %6s\n", $1, $2 * 1e3 / $4, \
+		$3 * 1e3 / $4, $5 / 1e3, $6 }'
+done
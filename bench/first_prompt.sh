@@ -0,0 +1,46 @@
+#!/bin/sh
+# Time to first prompt of an interactive bleshell at growing history
+# file sizes. The shell runs on a pseudo-terminal (script(1)) with
+# BLESHELL_STARTUP_STATS set and reports the time itself; the value
+# is the mean over RUNS starts. History is loaded in the background,
+# so the time should not depend on the file size; ok is "no" when a
+# size takes more than 3x the time of the smallest one (plus 1 ms).
+# Usage: bench/first_prompt.sh [line counts]   (default
+# "0 1000 100000 1000000", or BENCH_HIST_LINES; BENCH_HIST_RUNS starts
+# per size, default 10)
+
+SHELL_BIN=${SHELL_BIN:-./minishell}
+COUNTS=${1:-${BENCH_HIST_LINES:-"0 1000 100000 1000000"}}
+RUNS=${BENCH_HIST_RUNS:-10}
+ROOT=${BENCH_DIR:-/tmp}/bleshell_bench_hist
+BIN=$(cd "$(dirname "$SHELL_BIN")" && pwd)/$(basename "$SHELL_BIN")
+
+if ! command -v script > /dev/null; then
+	echo "first_prompt: script(1) not found, skipped"
+	exit 0
+fi
+rm -rf "$ROOT"
+mkdir -p "$ROOT"
+printf "%-8s %10s %6s\n" lines "ms/prompt" ok
+base=
+for n in $COUNTS; do
+	awk -v n="$n" 'BEGIN { for (i = 0; i < n; i++)
+		print "echo history line " i }' > "$ROOT/master"
+	total=0
+	r=0
+	while [ "$r" -lt "$RUNS" ]; do
+		# exit rewrites the history file, start each run from the master
+		cp "$ROOT/master" "$ROOT/bleshell_history"
+		us=$(cd "$ROOT" && printf 'exit\n' | BLESHELL_STARTUP_STATS=1 \
+			script -qec "$BIN" /dev/null 2>&1 | tr -d '\r' | awk \
+			'/first prompt after/ { print $(NF - 1) }')
+		total=$((total + ${us:-0}))
+		r=$((r + 1))
+	done
+	us=$((total / RUNS))
+	[ -z "$base" ] && base=$us
+	ok=no
+	[ "$us" -le $((base * 3 + 1000)) ] && ok=yes
+	echo "$n $us $ok" | awk '{ printf "%-8d %10.3f %6s\n", $1, $2 / 1e3, $3 }'
+done
+rm -rf "$ROOT"
@@ -0,0 +1,42 @@
+#!/bin/sh
+# Run time of a program found in the last of N PATH directories, at
+# growing N. Each line of the script is a command lookup plus a fork
+# and exec of true; the time per command should stay flat if lookups
+# do not depend on the number of PATH directories. ok is "no" when a
+# count costs more than 2x the us/cmd of the smallest one.
+# Usage: bench/path_lookup.sh [dir counts]   (default "1 100 1000",
+# or BENCH_PATH_DIRS; BENCH_PATH_CMDS commands per run, default 500)
+
+SHELL_BIN=${SHELL_BIN:-./minishell}
+COUNTS=${1:-${BENCH_PATH_DIRS:-"1 100 1000"}}
+CMDS=${BENCH_PATH_CMDS:-500}
+ROOT=${BENCH_DIR:-/tmp}/bleshell_bench_path
+SCRIPT=$ROOT/script
+TRUE_BIN=${BENCH_TRUE:-/bin/true}
+
+rm -rf "$ROOT"
+mkdir -p "$ROOT"
+awk -v n="$CMDS" 'BEGIN { for (i = 0; i < n; i++)
+	print "bleshell_bench_true" }' > "$SCRIPT"
+printf "%-8s %10s %10s %6s\n" dirs seconds "us/cmd" ok
+base=
+for n in $COUNTS; do
+	dirs=
+	i=1
+	while [ "$i" -le "$n" ]; do
+		mkdir -p "$ROOT/$n/d$i"
+		dirs="$dirs$ROOT/$n/d$i:"
+		i=$((i + 1))
+	done
+	ln -s "$TRUE_BIN" "$ROOT/$n/d$n/bleshell_bench_true"
+	start=$(date +%s.%N)
+	PATH="$dirs/usr/bin:/bin" "$SHELL_BIN" < "$SCRIPT" > /dev/null 2>&1
+	end=$(date +%s.%N)
+	us=$(echo "$start $end $CMDS" | awk '{ printf "%d", ($2 - $1) * 1e6 / $3 }')
+	[ -z "$base" ] && base=$us
+	ok=no
+	[ "$us" -le $((base * 2)) ] && ok=yes
+	echo "$start $end $n $us $ok" | awk \
+		'{ printf "%-8d %10.3f %10d %6s\n", $3, $2 - $1, $4, $5 }'
+done
+rm -rf "$ROOT"
@@ -0,0 +1,36 @@
+#!/bin/sh
+# Throughput of N-stage pipelines at different BLESHELL_PIPE_SIZE values.
+# Usage: bench/pipe_size.sh [bytes]   (default 4G, or BENCH_BYTES)
+
+SHELL_BIN=${SHELL_BIN:-./minishell}
+BYTES=${1:-${BENCH_BYTES:-4294967296}}
+SIZES=${BENCH_PIPE_SIZES:-"default 256k 1M"}
+STAGES=${BENCH_STAGES:-"2 4 8"}
+
+pipeline()
+{
+	cmd="head -c $BYTES /dev/zero"
+	i=2
+	while [ "$i" -lt "$1" ]; do
+		cmd="$cmd | cat"
+		i=$((i + 1))
+	done
+	echo "$cmd | wc -c"
+}
+
+printf "%-8s %-8s %10s %10s\n" stages size seconds "MB/s"
+for n in $STAGES; do
+	for size in $SIZES; do
+		if [ "$size" = default ]; then
+			unset BLESHELL_PIPE_SIZE
+		else
+			BLESHELL_PIPE_SIZE=$size
+			export BLESHELL_PIPE_SIZE
+		fi
+		start=$(date +%s.%N)
+		pipeline "$n" | "$SHELL_BIN" >/dev/null 2>&1
+		end=$(date +%s.%N)
+		echo "$start $end $BYTES" | awk -v n="$n" -v s="$size" \
+			'{ t = $2 - $1; printf "%-8s %-8s %10.3f %10.1f\n", n, s, t, $3 / t / 1048576 }'
+	done
+done
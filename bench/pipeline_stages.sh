@@ -0,0 +1,23 @@
+#!/bin/sh
+# Parse and run time of "echo x | cat | ... | cat" at growing stage counts.
+# Per-stage time should stay flat if the parser and VM scale linearly.
+# Usage: bench/pipeline_stages.sh [counts]   (default "10 100 1000 5000",
+# or BENCH_PIPE_STAGES)
+
+SHELL_BIN=${SHELL_BIN:-./minishell}
+COUNTS=${1:-${BENCH_PIPE_STAGES:-"10 100 1000 5000"}}
+SCRIPT=${BENCH_DIR:-/tmp}/bleshell_bench_stages
+
+printf "%-8s %10s %14s %6s\n" stages seconds "ms/stage" ok
+for n in $COUNTS; do
+	awk -v n="$n" 'BEGIN { s = "echo x"; for (i = 1; i < n; i++)
+		s = s " | cat"; print s }' > "$SCRIPT"
+	start=$(date +%s.%N)
+	out=$("$SHELL_BIN" < "$SCRIPT" 2>/dev/null)
+	end=$(date +%s.%N)
+	ok=no
+	[ "$out" = x ] && ok=yes
+	echo "$start $end $n $ok" | awk \
+		'{ t = $2 - $1; printf "%-8d %10.3f %14.4f %6s\n", $3, t, t * 1000 / $3, $4 }'
+done
+rm -f "$SCRIPT"
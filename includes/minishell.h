@@ -6,13 +6,17 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/13 15:16:53 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 11:34:55 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 20:55:37 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #ifndef MINISHELL_H
 # define MINISHELL_H
 
+# ifndef _GNU_SOURCE
+#  define _GNU_SOURCE
+# endif
+
 # include "libft.h"
 # include <stdio.h>
 # include <stdlib.h>
@@ -27,6 +31,19 @@
 # include <readline/readline.h>
 # include <readline/history.h>
 # include <sys/wait.h>
+# include <sys/stat.h>
+# include <sys/sendfile.h>
+# include <sys/mman.h>
+# include <sys/pidfd.h>
+# include <poll.h>
+# include <sys/signalfd.h>
+# include <sys/epoll.h>
+# include <dirent.h>
+# include <sys/inotify.h>
+# include <sys/syscall.h>
+# include <sys/eventfd.h>
+# include <pthread.h>
+# include <time.h>
 
 extern volatile sig_atomic_t	g_signal_received;
 
@@ -48,6 +65,161 @@ HIST_LINE_SZ - Buffer size for reading each history line in bytes.
 # define HIST_BUFFER_SZ 4096
 # define HIST_LINE_SZ 1024
 
+/*
+BUILTIN_SLOTS - Size of the builtin dispatch table (power of 2).
+BUILTIN_NAME_MAX - Length of the longest builtin name.
+*/
+# define BUILTIN_SLOTS 32
+# define BUILTIN_NAME_MAX 8
+
+/*
+IO_BUF_SZ - Output buffer size for builtin I/O contexts in bytes.
+FDPLAN_MAX - Maximum number of redirections on a single command.
+*/
+# define IO_BUF_SZ 8192
+# define FDPLAN_MAX 32
+
+/*
+ARENA_MIN - Smallest scratch arena allocation in bytes.
+*/
+# define ARENA_MIN 4096
+
+/*
+PIPE_SIZE_VAR - Variable holding the pipeline pipe size (e.g. "1M").
+PIPE_MAX_SIZE_FILE - System limit for unprivileged pipe sizes.
+PIPE_SIZE_DEFAULT_MAX - Limit assumed if that file is unreadable.
+*/
+# define PIPE_SIZE_VAR "BLESHELL_PIPE_SIZE"
+# define PIPE_MAX_SIZE_FILE "/proc/sys/fs/pipe-max-size"
+# define PIPE_SIZE_DEFAULT_MAX 1048576
+
+/*
+COPY_CHUNK - Bytes requested per splice()/sendfile()/copy_file_range().
+COPY_BUF_SZ - Buffer size for the read/write fallback in bytes.
+*/
+# define COPY_CHUNK 1048576
+# define COPY_BUF_SZ 131072
+
+/*
+INPUT_TTY - Interactive input through readline.
+INPUT_BATCH - Input from -c, a script file or a non-terminal stdin.
+BATCH_CHUNK - Initial read size for non-mapped batch input in bytes.
+*/
+# define INPUT_TTY 0
+# define INPUT_BATCH 1
+# define BATCH_CHUNK 65536
+
+/*
+JOBS_MAX - Size of the background job table.
+JOB_RUNNING/JOB_STOPPED/JOB_DONE - States of a job.
+JOB_POLL_MS - Poll interval for jobs without a pidfd in milliseconds.
+*/
+# define JOBS_MAX 64
+# define JOB_RUNNING 0
+# define JOB_STOPPED 1
+# define JOB_DONE 2
+# define JOB_POLL_MS 50
+
+/*
+EVENTS_MAX - Events fetched per epoll_wait() in the event loop.
+SPEC_IDLE_MS - Keyboard pause after which the line being typed at the
+prompt is parsed ahead of Enter.
+*/
+# define EVENTS_MAX 4
+# define SPEC_IDLE_MS 30
+
+/*
+PAR_JOBS_MAX - Upper limit for parallel -j.
+PAR_BUF_SZ - Initial output buffer per parallel job in bytes.
+PAR_ITEM_SEP - Word separating the parallel template from its items.
+PAR_FAILED_MAX - Highest exit status parallel reports for failed jobs.
+*/
+# define PAR_JOBS_MAX 256
+# define PAR_BUF_SZ 4096
+# define PAR_ITEM_SEP ":::"
+# define PAR_FAILED_MAX 101
+
+/*
+XARGS_HEADROOM - Bytes of ARG_MAX kept free as a safety margin.
+XARGS_ARG_STRLEN - Longest single argument the kernel accepts.
+XARGS_FAILED - xargs exit status when a batch fails.
+*/
+# define XARGS_HEADROOM 2048
+# define XARGS_ARG_STRLEN 131072
+# define XARGS_FAILED 123
+
+/*
+VEC_MIN - Smallest capacity a growable vector is given on first push.
+*/
+# define VEC_MIN 16
+
+/*
+SYN_EMPTY/SYN_WORD/SYN_PIPE/SYN_REDIR/SYN_BACKGROUND - Last token the
+validator has seen: none yet, a word, a pipe, a redirection operator
+or '&'.
+SYN_ERR_START - Pipe as the very first token.
+SYN_ERR_PIPES - Pipe right after another pipe.
+SYN_ERR_BG - '&' that does not follow a word, or a token after '&'.
+SYNTAX_COMPLETE - Command line can be run.
+SYNTAX_ERROR - Command line has a syntax error.
+SYNTAX_MORE_PIPE - Command line ends with a pipe, needs another line.
+SYNTAX_MORE_QUOTE - A quote is still open, needs another line.
+*/
+# define SYN_EMPTY 0
+# define SYN_WORD 1
+# define SYN_PIPE 2
+# define SYN_REDIR 3
+# define SYN_BACKGROUND 4
+# define SYN_ERR_START 1
+# define SYN_ERR_PIPES 2
+# define SYN_ERR_BG 3
+# define SYNTAX_COMPLETE 0
+# define SYNTAX_ERROR 1
+# define SYNTAX_MORE_PIPE 2
+# define SYNTAX_MORE_QUOTE 3
+
+/*
+PCACHE_SLOTS - Parsed command lines kept by the parse cache.
+PCACHE_STATS_VAR - Variable that makes the shell print cache hit
+rates on exit.
+*/
+# define PCACHE_SLOTS 64
+# define PCACHE_STATS_VAR "BLESHELL_PCACHE_STATS"
+
+/*
+STARTUP_STATS_VAR - Variable that makes an interactive shell print
+how long it took to show its first prompt.
+*/
+# define STARTUP_STATS_VAR "BLESHELL_STARTUP_STATS"
+
+/*
+COMP_DIR_SLOTS - Directory listings kept for filename completion.
+COMP_BREAK_CHARS - Characters that end the word being completed.
+Readline's default set also breaks on '$', which would make variable
+names impossible to complete.
+*/
+# define COMP_DIR_SLOTS 8
+# define COMP_BREAK_CHARS " \t\n\"'><=;|&("
+
+/*
+CMDTAB_NONE/READY/STALE/OFF - States of the PATH command table: never
+built, current, changed on disk, or not usable for this PATH.
+CMDTAB_MIN - Initial number of hash slots, a power of 2.
+CMDTAB_LAZY - PATH searches a script or -c run makes before the table
+is built; at the terminal it is built on the first lookup.
+CMDTAB_WATCH - inotify events that change what a PATH directory holds.
+DENTS_BUF_SZ - Buffer for one getdents64() call in bytes.
+*/
+# define CMDTAB_NONE 0
+# define CMDTAB_READY 1
+# define CMDTAB_STALE 2
+# define CMDTAB_OFF 3
+# define CMDTAB_MIN 256
+# define CMDTAB_LAZY 16
+# define CMDTAB_WATCH (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO \
+	| IN_DELETE_SELF | IN_MOVE_SELF)
+# define DENTS_BUF_SZ 32768
+
 /*
 String representations of token types.
 These constants match the enum e_tokentype values.
@@ -66,6 +238,21 @@ This enables easy conversion between enum and string.
 # define TOKEN_TYPE_EXPANSION        "$"
 # define TOKEN_TYPE_PIPE             "|"
 # define TOKEN_TYPE_EXIT_STATUS      "$?"
+# define TOKEN_TYPE_BACKGROUND       "&"
+
+/*
+Syntax validator state, advanced once per token as the lexer links it.
+- state: SYN_EMPTY, SYN_WORD, SYN_PIPE, SYN_REDIR or SYN_BACKGROUND.
+- error: 0, SYN_ERR_START, SYN_ERR_PIPES or SYN_ERR_BG. The first error
+  is kept.
+- error_pos: Offset in the command line where the error was found.
+*/
+typedef struct s_syntax
+{
+	int	state;
+	int	error;
+	int	error_pos;
+}	t_syntax;
 
 /*
 This structure is used to store the context of quotes.
@@ -96,23 +283,129 @@ typedef enum e_tokentype
 	TYPE_EXPANSION = 10,
 	TYPE_PIPE = 11,
 	TYPE_EXIT_STATUS = 12,
+	TYPE_BACKGROUND = 13,
 }	t_tokentype;
 
+/*
+Instructions of a compiled command line.
+- OP_REDIR: Add the redirection node to the current stage's fd plan.
+- OP_EXPAND: Expand the command node's words into a new argv.
+- OP_PIPE: Open a pipe from the current stage to the next.
+- OP_SPAWN: Fork and exec the current stage.
+- OP_RUN_BUILTIN: Run the current stage inside the shell.
+- OP_WAIT: Wait for every spawned stage and set the exit status.
+*/
+typedef enum e_opcode
+{
+	OP_REDIR = 0,
+	OP_EXPAND = 1,
+	OP_PIPE = 2,
+	OP_SPAWN = 3,
+	OP_RUN_BUILTIN = 4,
+	OP_WAIT = 5,
+}	t_opcode;
+
+/*
+One segment of a word template.
+- var: 0 for literal text, 1 for a variable reference.
+- text/len: Literal text, or the variable name without '$'.
+  Points into the parsed word, nothing is copied.
+*/
+typedef struct s_wseg
+{
+	int		var;
+	char	*text;
+	int		len;
+}	t_wseg;
+
+/*
+A parsed word split into literal and variable segments.
+- segs/count: The segments, in order. segs is NULL for the entry
+  ending a node's word array.
+*/
+typedef struct s_word
+{
+	t_wseg	*segs;
+	int		count;
+}	t_word;
+
+/*
+Bump allocator for memory that lives for one execution step.
+- buf/used/cap: Block, bytes handed out, block size.
+*/
+typedef struct s_arena
+{
+	char	*buf;
+	size_t	used;
+	size_t	cap;
+}	t_arena;
+
 /*
 Node structure for linked list and AST.
 Next and prev are for building linked list.
 Left and right are for building AST.
+words holds the templates of a command's args once prepare_words()
+has split them; args itself is never changed by expansion.
+argc/arg_cap count the entries of args (without its NULL) and the slots
+allocated for it, so append_arg() grows args by doubling.
 */
 typedef struct s_node
 {
 	t_tokentype		type;
 	char			**args;
+	int				argc;
+	int				arg_cap;
+	t_word			*words;
 	struct s_node	*next;
 	struct s_node	*prev;
 	struct s_node	*left;
 	struct s_node	*right;
 }	t_node;
 
+/*
+An AST flattened into one block for execution and caching.
+- Nodes are stored in command-line order (left subtree, node, right
+  subtree) and linked by 32-bit indices instead of pointers.
+- count/root: Number of nodes, index of the root node.
+- type/left/right: Token type and child indices of each node, -1 for
+  no child.
+- arg_start/arg_count: Where each node's words start in argv and
+  words, and how many there are. Each node's range is followed by a
+  NULL entry, so &argv[arg_start[i]] is a normal argv.
+- argv: Parsed words, pointing into pool.
+- words: Expansion templates of argv.
+- segs: Segments of every template, pointing into pool.
+- pool: Text of every word, back to back.
+The whole block is one allocation, released with a single free().
+*/
+typedef struct s_flatast
+{
+	int			count;
+	int			root;
+	t_tokentype	*type;
+	int			*left;
+	int			*right;
+	int			*arg_start;
+	int			*arg_count;
+	char		**argv;
+	t_word		*words;
+	t_wseg		*segs;
+	char		*pool;
+}	t_flatast;
+
+/*
+Running totals while an AST is measured and copied into a t_flatast.
+- nodes/words/segs/pool: Nodes, word slots (including each node's
+  NULL entry), word segments and pool bytes.
+*/
+typedef struct s_flatsize
+{
+	int		nodes;
+	int		words;
+	int		segs;
+	size_t	pool;
+}	t_flatsize;
+
 /*
 Structure for storing execution context.
 Has variables tracking current execution state.
@@ -171,7 +464,6 @@ typedef struct s_pipe
 	/* Pipe structure */
 	int         pipe_count;     // Number of pipes in the chain
 	t_node      **exec_cmds;     // Array of command nodes for execution
-	t_node      *cmd_nodes[100]; // Command nodes from parsing phase
 	int         cmd_count;      // Count of command nodes 
 	int         *pipe_fds;      // Array of pipe file descriptors
 	pid_t       *pids;          // Array of process IDs
@@ -185,6 +477,263 @@ typedef struct s_pipe
 	int         last_cmdcode;    // Status of the last command (for return value)
 } t_pipe;
 
+/*
+Command line text that spans several input lines.
+- data: Joined lines, '\0'-terminated.
+- len: Characters in data, excluding the terminator.
+- cap: Allocated size of data.
+Grows by doubling, so adding a continuation line only copies the new line.
+*/
+typedef struct s_linebuf
+{
+	char	*data;
+	int		len;
+	int		cap;
+}	t_linebuf;
+
+/*
+Source of command lines when not reading from a terminal.
+- mode: INPUT_TTY or INPUT_BATCH.
+- fd: Descriptor being read, -1 for a -c string.
+- data: Mapped file, read buffer or -c string.
+- len: Bytes available in data.
+- cap: Size of the read buffer (unused when mapped).
+- pos: Offset of the next unread byte.
+- mapped: 1 if data comes from mmap().
+- eof: 1 once no more data can arrive.
+- lines: Lines handed out by shell_readline() so far, any mode.
+*/
+typedef struct s_input
+{
+	int		mode;
+	int		fd;
+	char	*data;
+	size_t	len;
+	size_t	cap;
+	size_t	pos;
+	int		mapped;
+	int		eof;
+	long	lines;
+}	t_input;
+
+/*
+State of the shell's event loop.
+- sigfd: signalfd for SIGINT, SIGQUIT, SIGCHLD and SIGWINCH.
+- epfd: epoll set watching sigfd and the terminal.
+- mask: The signals routed to sigfd (blocked in the shell).
+- line/done: Result of the readline callback for the current prompt.
+- speculate: 1 while the main prompt is read, so the line being typed
+  may be parsed ahead (never set for continuation or heredoc prompts).
+*/
+typedef struct s_events
+{
+	int			sigfd;
+	int			epfd;
+	sigset_t	mask;
+	char		*line;
+	int			done;
+	int			speculate;
+}	t_events;
+
+/*
+One background or stopped job.
+- id: Job number shown as [id], 0 if the slot is free.
+- pid: Process id of the job's subshell, or process group of a
+  command line stopped in the foreground.
+- pidfd: pidfd_open() descriptor, -1 if unsupported.
+- state: JOB_RUNNING, JOB_STOPPED or JOB_DONE.
+- status: Exit code once the job has finished.
+- procs: Processes of the job not yet reaped.
+- last: Process whose exit code is the job's (last pipeline stage).
+- cmd: Command line text for jobs/fg/bg output.
+*/
+typedef struct s_job
+{
+	int		id;
+	pid_t	pid;
+	int		pidfd;
+	int		state;
+	int		status;
+	int		procs;
+	pid_t	last;
+	char	*cmd;
+}	t_job;
+
+/*
+One parsed command line kept by the parse cache.
+- hash/line: FNV-1a hash and text of the input line, NULL if free.
+- ast: Flat AST of the line; the cache owns it.
+- background: 1 if the line ended with '&' (token already removed).
+- stamp: Last use, for least-recently-used eviction.
+*/
+typedef struct s_pcentry
+{
+	unsigned long	hash;
+	char			*line;
+	t_flatast		*ast;
+	int				background;
+	unsigned long	stamp;
+}	t_pcentry;
+
+/*
+LRU cache from input lines to their flat ASTs.
+- clock: Use counter stamped into entries.
+- hits/misses: Lookups served from and missed by the cache.
+- active: 1 while vars->flat belongs to a cache entry.
+- spec: Line parsed while it was being typed, not yet in a slot.
+- spec_hits: Hits served by spec, also counted in hits.
+*/
+typedef struct s_pcache
+{
+	t_pcentry		slots[PCACHE_SLOTS];
+	unsigned long	clock;
+	int				hits;
+	int				misses;
+	int				active;
+	t_pcentry		spec;
+	int				spec_hits;
+}	t_pcache;
+
+/*
+One node of the command name trie.
+- child: First child, -1 if none. Children are sorted by c, so a
+  depth-first walk yields names in strcmp() order.
+- next: Next sibling, -1 if none.
+- c: Character on the edge into this node (unused for the root).
+- word: 1 if the path from the root to this node spells a full name.
+*/
+typedef struct s_trienode
+{
+	int		child;
+	int		next;
+	char	c;
+	char	word;
+}	t_trienode;
+
+/*
+Trie of command names, nodes linked by index in one vector.
+- nodes/count/cap: Node vector, nodes[0] is the root.
+*/
+typedef struct s_trie
+{
+	t_trienode	*nodes;
+	int			count;
+	int			cap;
+}	t_trie;
+
+/*
+Cached listing of one directory for filename completion.
+- path: Directory as passed to opendir(), NULL if the slot is free.
+- mtime: Directory mtime when it was listed. Any change to the entries
+  changes it, which makes the listing stale.
+- text: All entry names back to back, NUL separated.
+- names/count: Entry names in directory order, pointing into text.
+- stamp: Last use, for least-recently-used eviction.
+*/
+typedef struct s_dirlist
+{
+	char			*path;
+	struct timespec	mtime;
+	t_linebuf		text;
+	char			**names;
+	int				count;
+	unsigned long	stamp;
+}	t_dirlist;
+
+/*
+State of tab completion.
+- cmds: Trie of builtins and executables found in PATH.
+- dirs/mtimes: PATH directories the trie was built from and their
+  mtimes at the time (zero for a directory that did not exist).
+- cache/clock: Directory listings and their use counter.
+- matches/count/cap: Matches collected for the current completion.
+*/
+typedef struct s_comp
+{
+	t_trie			cmds;
+	char			**dirs;
+	struct timespec	*mtimes;
+	t_dirlist		cache[COMP_DIR_SLOTS];
+	unsigned long	clock;
+	char			**matches;
+	int				count;
+	int				cap;
+}	t_comp;
+
+/*
+Directory entry as returned by getdents64(2), which glibc does not
+declare.
+*/
+typedef struct s_dirent64
+{
+	unsigned long long	d_ino;
+	long long			d_off;
+	unsigned short		d_reclen;
+	unsigned char		d_type;
+	char				d_name[];
+}	t_dirent64;
+
+/*
+One slot of the PATH command table.
+- hash: pcache_hash() of the name.
+- name: Offset of the name in the table's names, -1 if the slot is free.
+- dir: Index of the PATH directory holding it.
+*/
+typedef struct s_cmdent
+{
+	unsigned long	hash;
+	int				name;
+	int				dir;
+}	t_cmdent;
+
+/*
+Table of every program found in the PATH directories, for command lookup.
+- state: CMDTAB_NONE, CMDTAB_READY, CMDTAB_STALE or CMDTAB_OFF.
+- path: PATH value the table was built from.
+- dirs: PATH directories, entries refer to them by index.
+- ifd: inotify descriptor watching each directory, -1 if none.
+- polled: 1 if ifd is in the event loop's epoll set.
+- slots/cap/count: Open addressing hash table, cap is a power of 2.
+- names: Entry names back to back, NUL separated.
+- misses: Lookups left to search_in_env() while the table is not
+  built, see CMDTAB_LAZY.
+*/
+typedef struct s_cmdtab
+{
+	int			state;
+	char		*path;
+	char		**dirs;
+	int			ifd;
+	int			polled;
+	t_cmdent	*slots;
+	int			cap;
+	int			count;
+	t_linebuf	names;
+	int			misses;
+}	t_cmdtab;
+
+/*
+History file being read by the loader thread.
+- thread: Loader thread, joined by hist_merge().
+- loading: 1 from load_history() until hist_merge() ran.
+- efd: eventfd the loader signals when it is done, -1 if none.
+- epfd: epoll set efd was added to, -1 if none.
+- owner: Process that started the loader. A forked child has no
+  loader thread and never joins it.
+- text/start: Contents of the history file, lines NUL separated; the
+  lines to load begin at offset start.
+*/
+typedef struct s_histload
+{
+	pthread_t	thread;
+	int			loading;
+	int			efd;
+	int			epfd;
+	pid_t		owner;
+	t_linebuf	text;
+	int			start;
+}	t_histload;
+
 /*
 Main structure for storing variables and context.
 Makes it easier to access and pass around.
@@ -196,53 +745,280 @@ Has variables tracking:
 */
 typedef struct s_vars
 {
-	t_node      	*cmd_nodes[100];
+	t_node      	**cmd_nodes;
 	int				cmd_count;
+	int				cmd_cap;
 	t_node			*astroot;
 	t_node			*head;
 	t_node			*current;
 	t_tokentype		curr_type;
 	t_tokentype		prev_type;
 	char			**env;
-	t_quote_context	quote_ctx[32];
+	t_quote_context	*quote_ctx;
 	int				quote_depth;
+	int				quote_cap;
 	int				pos;
 	int				start;
+	int				first_token;
+	t_syntax		syntax;
 	int				shell_level;
 	int				error_code;
 	char			*error_msg;
+	int				pipe_max_size;
+	int				pipe_size;
+	t_input			input;
+	t_events		events;
+	int				job_control;
+	pid_t			shell_pgid;
+	pid_t			pgid;
+	struct termios	tmodes;
+	t_job			jobs[JOBS_MAX];
+	int				job_current;
+	int				subshell;
+	t_pcache		pcache;
+	t_comp			comp;
+	t_cmdtab		cmdtab;
+	t_histload		hist;
+	struct timespec	started;
+	t_flatast		*flat;
 	t_pipe          *pipeline;     // Current pipeline being executed
 } t_vars;
 
+/*
+I/O context handed to builtins instead of the shell's stdio.
+- in/out/err: Descriptors the builtin reads from and writes to.
+- buf/len: Buffered output, flushed with io_flush().
+- failed: Set once a write to out fails (e.g. EPIPE).
+Redirected builtins get the opened files here directly, so the shell's
+own stdin/stdout are never dup2'd.
+*/
+typedef struct s_io
+{
+	int		in;
+	int		out;
+	int		err;
+	int		len;
+	int		failed;
+	char	buf[IO_BUF_SZ];
+}	t_io;
+
+/*
+One step of a command's redirection plan.
+- target: Descriptor to replace (STDIN_FILENO or STDOUT_FILENO).
+- path: File to open in the child, NULL if fd is already open.
+- flags: open() flags for path.
+- fd: Descriptor opened by the shell (heredoc pipe), -1 otherwise.
+*/
+typedef struct s_fdop
+{
+	int		target;
+	char	*path;
+	int		flags;
+	int		fd;
+}	t_fdop;
+
+/*
+All redirections of one command, in command-line order.
+*/
+typedef struct s_fdplan
+{
+	t_fdop	ops[FDPLAN_MAX];
+	int		count;
+}	t_fdplan;
+
+/*
+Descriptor for a builtin command in the dispatch table.
+- name: Command name as typed by the user.
+- fn: Handler receiving the full argument vector.
+- in_parent: 1 if it only produces output and does not change shell
+  state, so it may run in the shell process as a pipeline stage.
+- needs_stdin: 1 if the builtin reads from standard input.
+*/
+typedef struct s_builtin
+{
+	const char	*name;
+	int			(*fn)(char **args, t_vars *vars, t_io *io);
+	int			in_parent;
+	int			needs_stdin;
+}	t_builtin;
+
+/*
+One job slot of the parallel builtin.
+- pid: Running job, 0 if the slot is free.
+- fd: Read end of the job's stdout pipe.
+- buf/len/cap: Output held back until the job ends.
+*/
+typedef struct s_pslot
+{
+	pid_t	pid;
+	int		fd;
+	char	*buf;
+	size_t	len;
+	size_t	cap;
+}	t_pslot;
+
+/*
+State of one parallel run.
+- tmpl: Command template words ("{}" marks the item).
+- items: Items still to run, NULL-terminated.
+- path: Resolved path of an external template command.
+- builtin: Descriptor if the template command is a builtin.
+- jobs/running/failed: Slot count, busy slots, failed jobs.
+- sep/sep_word: Index and text of the ":::" word cut out of args.
+*/
+typedef struct s_parallel
+{
+	char			**tmpl;
+	char			**items;
+	char			*path;
+	const t_builtin	*builtin;
+	int				jobs;
+	int				running;
+	int				failed;
+	int				sep;
+	char			*sep_word;
+	t_pslot			slots[PAR_JOBS_MAX];
+}	t_parallel;
+
+/*
+State of one xargs run.
+- par: Job slots and template, shared with the parallel builtin.
+- data/len: Input read from stdin, cut into items in place.
+- split: Item pointers into data (NULL when items come from ":::").
+- next: Index of the first item not yet in a batch.
+- budget: Bytes available for items in one execve().
+- max_args: Limit from -n, 0 for no limit.
+- nul: 1 for NUL-separated input (-0).
+*/
+typedef struct s_xargs
+{
+	t_parallel	par;
+	char		*data;
+	size_t		len;
+	char		**split;
+	size_t		next;
+	size_t		budget;
+	int			max_args;
+	int			nul;
+}	t_xargs;
+
+/*
+One instruction of a compiled command line.
+- op: Opcode from t_opcode.
+- node: Index of the flat AST node it works on (-1 for OP_PIPE and
+  OP_WAIT).
+*/
+typedef struct s_insn
+{
+	int		op;
+	int		node;
+}	t_insn;
+
+/*
+A command line compiled to a flat instruction stream.
+- ast: Flat AST the instructions index into; not owned.
+- code/len/cap: Instructions, used and allocated count.
+- stage/stages/stage_cap: Root node of each pipeline stage, number
+  of stages and allocated count.
+*/
+typedef struct s_program
+{
+	t_flatast	*ast;
+	t_insn		*code;
+	int			len;
+	int			cap;
+	int			*stage;
+	int			stages;
+	int			stage_cap;
+}	t_program;
+
+/*
+Registers of the VM running a program.
+- prog: Program being run.
+- arena: Scratch memory holding the current stage's argv.
+- argv: Expanded words of the current stage.
+- plan: Redirections of the current stage.
+- in_fd: Read end of the previous stage's pipe, -1 for none.
+- pipefd: Pipe to the next stage, -1 for none.
+- pids/npids: Stages running in children.
+- last_pid: Child running the last stage, -1 if it ran in the shell.
+- status: Exit status of the last stage if it ran in the shell.
+*/
+typedef struct s_vm
+{
+	t_program	*prog;
+	t_arena		arena;
+	char		**argv;
+	t_fdplan	plan;
+	int			in_fd;
+	int			pipefd[2];
+	pid_t		*pids;
+	int			npids;
+	pid_t		last_pid;
+	int			status;
+}	t_vm;
+
 /* Builtin commands functions. In srcs/builtins directory. */
 
 /*
 builtin_cd.c - Builtin "cd" command. Changes the current working directory.
 In builtin_cd.c
 */
-int			builtin_cd(char **args, t_vars *vars);
-int			handle_cd_special(char **args, t_vars *vars);
-int			handle_cd_path(char **args, t_vars *vars);
+int			builtin_cd(char **args, t_vars *vars, t_io *io);
+int			handle_cd_special(char **args, t_vars *vars, t_io *io);
+int			handle_cd_path(char **args, t_vars *vars, t_io *io);
 int			update_env_pwd(t_vars *vars, char *oldpwd);
 
+/*
+Batch (non-interactive) input handling.
+In batch_input.c
+*/
+void		init_input_string(t_input *in, char *str);
+int			init_input_fd(t_input *in, int fd);
+void		init_input_file(t_input *in, char *path);
+void		setup_input(t_vars *vars, int argc, char **argv);
+ssize_t		batch_refill(t_input *in);
+char		*batch_readline(t_input *in);
+int			batch_is_last(t_input *in);
+char		*shell_readline(const char *prompt, t_vars *vars);
+void		free_input(t_input *in);
+
+/*
+Builtin "cat" command. Copies files or STDIN to STDOUT.
+In builtin_cat.c
+*/
+int			copy_error(const char *cmd, const char *file, const char *msg,
+				t_io *io);
+int			copy_supported(char **args, const char *known);
+int			copy_external(char **args, t_vars *vars, t_io *io);
+int			cat_file(const char *file, t_io *io);
+int			builtin_cat(char **args, t_vars *vars, t_io *io);
+
 /*
 Builtin "echo" command. Outputs arguments to STDOUT.
 In builtin_echo.c
 */
-int			builtin_echo(char **args, t_vars *vars);
-int			process_echo_args(char **args, int start, int nl_flag);
+int			builtin_echo(char **args, t_vars *vars, t_io *io);
+int			process_echo_args(char **args, int start, int nl_flag, t_io *io);
+
+/*
+Builtin "fg" and "bg" commands. Resume a background job.
+In builtin_fg.c
+*/
+int			builtin_fg(char **args, t_vars *vars, t_io *io);
+int			builtin_bg(char **args, t_vars *vars, t_io *io);
 
 /*
 Builtin "env" command. Outputs the environment variables.
 In builtin_env.c
 */
-int			builtin_env(t_vars *vars);
+int			builtin_env(char **args, t_vars *vars, t_io *io);
 
 /*
 Builtin "exit" command. Exits the shell.
 In builtin_exit.c
 */
-int			builtin_exit(t_vars *vars);
+int			builtin_exit(char **args, t_vars *vars, t_io *io);
 
 /*
 Builtin "export" command utility functions.
@@ -251,23 +1027,41 @@ In builtin_export_utils.c
 char		*valid_export(char *args);
 char		**asc_order(char **sort_env, int count);
 char		**make_sorted_env(int count, t_vars *vars);
-int			process_export_var(char *env_var);
-int			process_var_with_val(char *name, char *value);
+int			process_export_var(char *env_var, t_io *io);
+int			process_var_with_val(char *name, char *value, t_io *io);
 
 /*
 Builtin "export" command. Sets an environment variable.
 In builtin_export.c
 */
-int			builtin_export(char **args, t_vars *vars);
-int			export_without_args(t_vars *vars);
-int			export_with_args(char **args, t_vars *vars);
-int			sort_env(int count, t_vars *vars);
+int			builtin_export(char **args, t_vars *vars, t_io *io);
+int			export_without_args(t_vars *vars, t_io *io);
+int			export_with_args(char **args, t_vars *vars, t_io *io);
+int			sort_env(int count, t_vars *vars, t_io *io);
+
+/*
+Builtin "jobs" command. Lists background jobs.
+In builtin_jobs.c
+*/
+int			builtin_jobs(char **args, t_vars *vars, t_io *io);
+
+/*
+Builtin "parallel" command. Runs a command per item, N at a time.
+In builtin_parallel.c
+*/
+int			par_parse(char **args, t_parallel *par, t_io *io);
+char		*par_read_all(int fd, size_t *len);
+char		**par_read_items(int fd);
+int			par_resolve(t_parallel *par, t_vars *vars, t_io *io);
+void		par_cleanup(t_parallel *par, char **args, char **read_items,
+				t_io *io);
+int			builtin_parallel(char **args, t_vars *vars, t_io *io);
 
 /*
 Builtin "pwd" command. Outputs the current working directory.
 In builtin_pwd.c
 */
-int			builtin_pwd(t_vars *vars);
+int			builtin_pwd(char **args, t_vars *vars, t_io *io);
 
 /*
 Builtin "unset" command utility functions.
@@ -280,12 +1074,31 @@ void		copy_env_back(char **src, char **dst, int idx, int offset);
 Builtin "unset" command. Unsets an environment variable.
 In builtin_unset.c
 */
-int			builtin_unset(char **args, t_vars *vars);
+int			builtin_unset(char **args, t_vars *vars, t_io *io);
 int			set_next_pos(int changes, char **env, int pos);
 char		**realloc_until_var(int changes, char **env, char *var, int count);
 int			get_env_pos(char *var, char **env);
 void		modify_env(char ***env, int changes, char *var);
 
+/*
+Builtin "wait" command. Waits for background jobs.
+In builtin_wait.c
+*/
+int			wait_job(t_vars *vars, t_job *job, int options);
+int			wait_next_job(t_vars *vars);
+int			builtin_wait(char **args, t_vars *vars, t_io *io);
+
+/*
+Builtin "xargs" command. Runs a command on items in ARG_MAX batches.
+In builtin_xargs.c
+*/
+int			xargs_parse(char **args, t_xargs *xa, t_io *io);
+char		**xargs_split(char *data, size_t len, int nul);
+size_t		xargs_budget(char **tmpl, char **env);
+size_t		xargs_batch(t_xargs *xa, char **argv);
+int			builtin_xargs(char **args, t_vars *vars, t_io *io);
+int			xargs_run(t_xargs *xa, char **argv, t_vars *vars, t_io *io);
+
 /* Main minishell functions. In srcs directory. */
 
 /*
@@ -330,14 +1143,10 @@ void		link_strargs_to_cmds(t_vars *vars);
 void		debug_print_pipe_info(t_node *pipe_node, char *position_msg);
 void		link_addon_pipe(t_node *last_pipe, t_node *new_pipe, t_node *right_cmd);
 void		build_pipe_ast(t_vars *vars);
+void		wrap_redir_segment(t_vars *vars, t_node *cmd, t_node *first);
+void		link_redirs_to_cmds(t_vars *vars);
 void		process_token_list(t_vars *vars);
 t_node		*set_ast_root(t_node *pipe_node, t_vars *vars);
-int			chk_start_pipe(t_vars *vars);
-int			detect_multi_pipes(t_vars *vars, int pipes_count);
-int			detect_adj_pipes(t_vars *vars, t_node *current);
-int			chk_next_pipes(t_vars *vars);
-int			chk_end_pipe(t_vars *vars);
-int			chk_pipe_syntax_err(t_vars *vars);
 char		*merge_input(char *input, char *line);
 char		*handle_trailing_pipe_pt1(char *input, t_vars *vars);
 char		*handle_trailing_pipe_pt2(char *new_input, t_vars *vars);
@@ -345,15 +1154,39 @@ char		*handle_incomplete_pipe(char *input, t_vars *vars);
 t_node		*build_ast(t_vars *vars);
 void		debug_print_token_attrib(t_node *current, int i);
 void		debug_print_token_list(t_vars *vars);
-int			check_initial_pipe(t_vars *vars, t_ast *ast);
-int			check_bad_pipe_series(t_vars *vars);
+
+/*
+Builtin "tee" command. Copies STDIN to STDOUT and files.
+In builtin_tee.c
+*/
+int			open_tee_files(char **args, int append, int *fds, t_io *io);
+int			splice_all(int in, int out, ssize_t len);
+int			tee_zero_copy(int in, int out, int file);
+int			tee_rw(t_io *io, int *fds, int count);
+int			tee_copy(t_io *io, int *fds, int count);
+int			builtin_tee(char **args, t_vars *vars, t_io *io);
+
+/*
+Builtin I/O context handling.
+In builtin_io.c
+*/
+void		init_io(t_io *io, int in, int out, int err);
+int			io_flush(t_io *io);
+int			io_write_direct(t_io *io, const char *str, size_t len);
+int			io_write(t_io *io, const char *str, size_t len);
+int			io_putstr(t_io *io, const char *str);
+int			io_putendl(t_io *io, const char *str);
 
 /*
 Builtin control handling.
 In builtin.c
 */
+int			builtin_hash(const char *name);
+const t_builtin	*builtin_table(void);
+const t_builtin	*get_builtin(const char *cmd);
 int			is_builtin(char *cmd);
-int			execute_builtin(char *cmd, char **args, t_vars *vars);
+int			execute_builtin(char *cmd, char **args, t_vars *vars, t_io *io);
+int			is_parent_builtin_stage(t_node *node);
 
 /*
 Group A of cleanup functions.
@@ -393,11 +1226,124 @@ int			handle_cmd_status(int status, t_vars *vars);
 int			setup_out_redir(t_node *node, int *fd, int append);
 int			setup_in_redir(t_node *node, int *fd);
 int			setup_redirection(t_node *node, t_vars *vars, int *fd);
+t_node		*get_redir_cmd(t_node *node);
 int			exec_redirect_cmd(t_node *node, char **envp, t_vars *vars);
-int			exec_child_cmd(t_node *node, char **envp, t_vars *vars, char *cmd_path);
+int			exec_child_cmd(t_node *node, t_vars *vars, char *cmd_path,
+				t_fdplan *plan);
 void		print_cmd_args(t_node *node);
+int			can_replace_shell(t_vars *vars);
+int			is_final_cmd(t_node *node, t_vars *vars);
+void		exec_in_place(t_node *node, t_vars *vars, char *cmd_path,
+				t_fdplan *plan);
+int			exec_external_cmd(t_node *node, char **envp, t_vars *vars,
+				t_fdplan *plan);
 int			exec_std_cmd(t_node *node, char **envp, t_vars *vars);
+int			run_flat(t_flatast *ast, t_vars *vars);
 int			execute_cmd(t_node *node, char **envp, t_vars *vars);
+int			execute_ast(t_vars *vars);
+
+/*
+PATH command table.
+In cmd_table.c
+*/
+char		*env_path(char **envp);
+void		cmdtab_reset(t_cmdtab *tab, t_vars *vars);
+int			cmdtab_slot(t_cmdtab *tab, const char *name, unsigned long hash);
+int			cmdtab_grow(t_cmdtab *tab);
+int			cmdtab_add(t_cmdtab *tab, char *name, int dir);
+int			cmdtab_exec(int dirfd, t_dirent64 *ent);
+int			cmdtab_list(t_cmdtab *tab, int dir);
+int			cmdtab_watch(t_cmdtab *tab, t_vars *vars);
+void		cmdtab_build(t_cmdtab *tab, char *path, t_vars *vars);
+void		cmdtab_drain(t_cmdtab *tab);
+char		*cmdtab_find(char *cmd, char **envp, t_vars *vars);
+
+/*
+Tab completion.
+In complete.c
+*/
+t_vars		*comp_vars(t_vars *vars);
+void		init_completion(t_vars *vars);
+int			comp_add(t_comp *comp, char *match);
+int			comp_cmd_pos(char *line, int start);
+void		comp_drop(t_comp *comp);
+int			comp_lcd(t_comp *comp);
+char		**comp_result(t_comp *comp);
+char		**shell_completion(const char *text, int start, int end);
+
+/*
+Command and variable name completion.
+In complete_cmds.c
+*/
+int			trie_child(t_trie *trie, int parent, char c);
+int			trie_add(t_trie *trie, const char *word);
+int			trie_find(t_trie *trie, const char *prefix);
+void		trie_collect(t_trie *trie, int node, t_linebuf *word,
+				t_comp *comp);
+void		dir_mtime(const char *dir, struct timespec *mtime);
+int			path_index_stale(t_comp *comp, char **dirs);
+int			path_index_dir(t_trie *trie, char *path);
+int			path_index_build(t_comp *comp, char **dirs);
+void		comp_cmds(char *text, t_vars *vars);
+void		comp_env(char *text, t_vars *vars);
+
+/*
+Filename completion.
+In complete_files.c
+*/
+void		dir_free(t_dirlist *list);
+int			dir_read(t_dirlist *list, char *path);
+t_dirlist	*dir_listing(t_comp *comp, char *path);
+void		dir_matches(t_dirlist *list, char *dir, char *prefix,
+				t_comp *comp);
+char		*comp_dir_path(char *dir, t_vars *vars);
+void		comp_files(char *text, t_vars *vars);
+
+/*
+Bytecode compiler for command lines.
+In compile.c
+*/
+int			emit_insn(t_program *prog, int op, int node);
+int			collect_stages(t_program *prog, int node);
+int			stage_in_shell(t_program *prog, int stage, int cmd, int last);
+int			compile_stage(t_program *prog, int stage, int last);
+t_program	*compile_ast(t_flatast *ast);
+void		free_program(t_program *prog);
+
+/*
+Virtual machine running compiled command lines.
+In vm.c
+*/
+void		vm_end_stage(t_vm *vm);
+int			vm_open_plan(t_vm *vm, t_io *io, t_vars *vars);
+void		vm_exec(t_vm *vm, char *path, t_vars *vars);
+int			vm_spawn(t_vm *vm, t_vars *vars);
+int			vm_run_builtin(t_vm *vm, t_vars *vars);
+int			vm_wait(t_vm *vm, t_vars *vars);
+int			vm_step(t_vm *vm, t_insn *insn, t_vars *vars);
+int			vm_run(t_program *prog, t_vars *vars);
+
+/*
+Zero-copy data transfer between descriptors.
+In fdcopy.c
+*/
+int			copy_unsupported(int copied);
+int			copy_range(int in, int out);
+int			copy_splice(int in, int out);
+int			copy_sendfile(int in, int out);
+int			copy_rw(int in, int out);
+int			copy_fd(int in, int out);
+int			is_same_file(int in, int out);
+
+/*
+Redirection fd plan handling.
+In fdplan.c
+*/
+int			add_fdop(t_fdplan *plan, t_tokentype type, char *target,
+				t_vars *vars);
+int			build_fdplan(t_node *node, t_fdplan *plan, t_vars *vars);
+int			apply_fdplan(t_fdplan *plan, t_vars *vars);
+void		close_fdplan(t_fdplan *plan);
 
 /*
 Expansion handling.
@@ -410,7 +1356,48 @@ char		*get_var_name(char *input, int *pos);
 char		*append_char(char *str, char c);
 char		*handle_expansion(char *input, int *pos, t_vars *vars);
 int			expand_one_arg(char **arg, t_vars *vars);
-void		expand_cmd_args(t_node *node, t_vars *vars);
+
+/*
+Word templates and argv expansion.
+In words.c
+*/
+int			count_word_segs(char *word);
+int			split_word(char *word, t_wseg *segs);
+t_word		*build_words(char **args);
+void		prepare_words(t_node *node);
+char		*seg_value(t_wseg *seg, t_vars *vars, size_t *len);
+size_t		argv_size(t_word *words, t_vars *vars);
+char		**expand_words(t_word *words, t_arena *arena, t_vars *vars);
+char		**expand_argv(t_node *node, t_arena *arena, t_vars *vars);
+
+/*
+Flat AST building.
+In flatast.c
+*/
+void		flat_measure(t_node *node, t_flatsize *size);
+t_flatast	*flat_alloc(t_flatsize *size);
+void		flat_copy_args(t_flatast *ast, int i, char **args, t_flatsize *at);
+int			flat_fill(t_flatast *ast, t_node *node, t_flatsize *at);
+t_flatast	*flatten_ast(t_node *root);
+
+/*
+Per-execution scratch memory.
+In arena.c
+*/
+void		arena_init(t_arena *arena);
+int			arena_reserve(t_arena *arena, size_t size);
+void		*arena_alloc(t_arena *arena, size_t size);
+void		arena_free(t_arena *arena);
+
+/*
+Growable vectors for parser state.
+In vectors.c
+*/
+int			vec_reserve(void **items, int *cap, int need, size_t size);
+int			push_cmd_node(t_vars *vars, t_node *node);
+int			push_quote(t_vars *vars, char type);
+int			linebuf_add(t_linebuf *text, char sep, char *line);
+void		free_vectors(t_vars *vars);
 
 /*
 Heredoc checking and utility functions.
@@ -446,6 +1433,7 @@ int			write_to_heredoc(int fd, char *line, t_vars *vars, int expand_vars);
 int			read_heredoc(int *fd, char *delimiter, t_vars *vars, int expand_vars);
 int			handle_heredoc_err(t_node *node, t_vars *vars);
 int			cleanup_heredoc_fail(int *fd, t_vars *vars);
+int			open_heredoc(char *delimiter, t_vars *vars);
 int			handle_heredoc(t_node *node, t_vars *vars);
 int			proc_heredoc(t_node *node, t_vars *vars);
 
@@ -453,9 +1441,12 @@ int			proc_heredoc(t_node *node, t_vars *vars);
 History loading functions.
 In history_load.c
 */
-void		skip_history_lines(int fd, int skip_count);
-void		read_history_lines(int fd);
-void		load_history(void);
+t_histload	*hist_state(t_histload *hist);
+void		hist_read(t_histload *hist);
+void		*hist_thread(void *arg);
+void		load_history(t_vars *vars);
+void		hist_merge(t_histload *hist);
+int			hist_getc(FILE *stream);
 
 /* 
 History saving utility functions.
@@ -502,8 +1493,8 @@ void		init_lexer(t_vars *vars);
 Input completion functions.
 In input_completion.c
 */
-int			is_input_complete(t_vars *vars);
 int			check_unfinished_pipe(t_vars *vars, t_ast *ast);
+int			read_pipe_line(t_linebuf *text, t_vars *vars);
 int			handle_unfinished_pipes(char **processed_cmd, t_vars *vars,
 							t_ast *ast);
 char		*get_quote_input(t_vars *vars);
@@ -519,9 +1510,6 @@ In input_verify.c
 */
 int			tokenize_to_test(char *input, t_vars *vars);
 int			process_input_addons(char **processed_cmd, t_vars *vars, t_ast *ast);
-int			chk_pipe_before_cmd(t_vars *vars, t_ast *ast);
-int			chk_serial_pipes(t_vars *vars, t_ast *ast);
-int			chk_syntax_errors(t_vars *vars);
 int			chk_input_valid(t_vars *vars, char **input);
 char		*verify_input(char *input, t_vars *vars);
 int			count_tokens(t_node *head);
@@ -529,6 +1517,61 @@ int			prepare_input(char *input, t_vars *vars, char **processed_cmd);
 char		*join_with_newline(char *first, char *second);
 char		*append_new_input(char *first, char *second);
 
+/*
+Event loop handling.
+In event_loop.c
+*/
+t_events	*event_state(t_events *ev);
+void		event_line_handler(char *line);
+char		*event_readline(const char *prompt, t_vars *vars);
+int			wait_signal(t_vars *vars);
+
+/*
+Process group and terminal handling.
+In job_control.c
+*/
+void		init_job_control(t_vars *vars);
+void		join_job_pgrp(t_vars *vars, int foreground);
+void		track_job_pgrp(t_vars *vars, pid_t pid, int foreground);
+void		reclaim_terminal(t_vars *vars, int status);
+int			signal_job(t_vars *vars, t_job *job, int sig);
+
+/*
+Job control handling.
+In jobs.c
+*/
+int			free_job_slot(t_vars *vars);
+int			add_job(t_vars *vars, pid_t pid, char *cmd);
+void		pick_current_job(t_vars *vars);
+void		remove_job(t_vars *vars, t_job *job);
+t_job		*find_job(t_vars *vars, const char *spec);
+int			update_job(t_job *job, int status);
+int			reap_job(t_vars *vars, t_job *job, int options);
+int			stop_job(t_vars *vars, pid_t last, int procs, int status);
+int			collect_job_fds(t_vars *vars, struct pollfd *pfds, int *slot);
+int			poll_jobs(t_vars *vars, int timeout);
+void		print_job(t_vars *vars, t_job *job, t_io *io);
+void		report_jobs(t_vars *vars);
+char		*append_words(char *text, char **args);
+char		*job_cmd_text(t_vars *vars);
+int			detach_bg_token(t_vars *vars, int report);
+int			launch_job(t_vars *vars);
+
+/*
+Parallel job slot handling.
+In parallel.c
+*/
+char		**par_build_argv(char **tmpl, char *item);
+char		*par_subst(char *word, char *item);
+int			par_spawn(t_parallel *par, t_pslot *slot, char *item,
+				t_vars *vars);
+int			par_launch(t_parallel *par, t_pslot *slot, char **argv,
+				t_vars *vars);
+void		par_finish(t_parallel *par, t_pslot *slot, t_io *io);
+int			par_drain(t_parallel *par, t_io *io);
+int			par_reserve(t_pslot *slot);
+int			par_free_slot(t_parallel *par);
+
 /*
 Lexer utility functions.
 In lexer_utils.c
@@ -543,24 +1586,27 @@ char		*read_added_input(char *prompt);
 void		handle_text_chunk(char *str, t_vars *vars);
 void		process_text(char *str, t_vars *vars, int *first_token, t_tokentype override_type);	
 void		handle_quote_content(char *str, t_vars *vars, int *first_token);
-char		*lexing_unclosed_quo(char *input, t_vars *vars);
+int			lex_open_quotes(t_linebuf *text, t_vars *vars);
 void		handle_expansion_token(char *str, t_vars *vars, int *first_token);
 void		handle_token_boundary(char *str, t_vars *vars, int *first_token);
 void		create_operator_token(t_vars *vars, t_tokentype type, char *symbol);
 void		handle_operator_token(char *str, t_vars *vars, int *first_token);
 void		handle_token(char *str, t_vars *vars);
+void		lex_line(char *str, t_vars *vars);
 void		lexerlist(char *str, t_vars *vars);
 
 /*
 Minishell program entry point functions.
 In minishell.c
 */
+void		startup_report(t_vars *vars);
 char		*reader(t_vars *vars);
 void		setup_env(t_vars *vars, char **envp);
 void		init_shell(t_vars *vars, char **envp);
 char		*handle_quote_completion(char *cmd, t_vars *vars);
 char		*handle_pipe_valid(char *cmd, t_vars *vars, int syntax_chk);
-void		build_and_execute(t_vars *vars);
+void		run_ast(t_vars *vars, int background);
+void		build_and_execute(t_vars *vars, char *line);
 char		*process_input_tokens(char *command, t_vars *vars);
 char		*process_pipe_syntax(char *command, char *orig_cmd, t_vars *vars);
 int			process_command(char *command, t_vars *vars);
@@ -585,6 +1631,20 @@ t_tokentype	get_operator_type(char op);
 int			handle_single_operator(char *input, int i, t_vars *vars);
 int			handle_double_operator(char *input, int i, t_vars *vars);
 
+/*
+Parse cache handling.
+In parse_cache.c
+*/
+unsigned long	pcache_hash(const char *line);
+int			pcache_cacheable(char *line);
+t_pcentry	*pcache_find(t_pcache *cache, char *line, unsigned long hash);
+void		pcache_free_entry(t_pcentry *entry);
+t_pcentry	*pcache_slot(t_pcache *cache);
+void		pcache_store(char *line, int background, t_vars *vars);
+void		pcache_release(t_vars *vars);
+int			run_cached_cmd(char *line, t_vars *vars);
+void		pcache_report(t_vars *vars);
+
 /*
 Path finding functions.
 In paths.c
@@ -592,8 +1652,11 @@ In paths.c
 char		**get_path_env(char **envp);
 char		*try_path(char *path, char *cmd);
 char		*search_in_env(char *cmd, char **envp);
-char		*get_cmd_path(char *cmd, char **envp);
-char		**dup_env(char **envp);
+char		*get_cmd_path(char *cmd, char **envp, t_vars *vars);
+int			env_borrowed(char **envp, const char *entry);
+char		**import_env(char **envp);
+void		free_env_entry(char *entry);
+void		free_env(char **env);
 
 /*
 Pipeline handling utility functions.
@@ -614,6 +1677,10 @@ In pipes_execution.c
 Pipes syntax checking functions.
 In pipes_syntax.c
 */
+void		syntax_reset(t_vars *vars);
+void		syntax_step(t_vars *vars, t_tokentype type);
+int			syntax_status(t_vars *vars);
+int			chk_syntax(t_vars *vars);
 
 /*
 Pipes main functions.
@@ -621,7 +1688,7 @@ In pipes.c
 */
 void		init_pipe(t_node *cmd, int *pipe_fd);
 int			validate_pipe_node(t_node *pipe_node);
-int			setup_pipe(int *pipefd);
+int			setup_pipe(int *pipefd, t_vars *vars);
 void		exec_left_cmd(t_node *pipe_node, int *pipefd, t_vars *vars);
 void		exec_right_cmd(t_node *pipe_node, int *pipefd, t_vars *vars);
 pid_t		make_child_proc(t_node *pipe_node, int *pipefd, t_vars *vars,
@@ -633,8 +1700,19 @@ int			prep_pipe_complete(char *cmd, char **result, char **pipe_cmd,
 char		*handle_pipe_completion(char *cmd, t_vars *vars, int syntax_chk);
 int			setup_pipeline_procs(t_node *pipe_node, t_vars *vars,
 				pid_t *left_pid, pid_t *right_pid);
+int			exec_parent_stage(t_node *pipe_node, int *pipefd, pid_t left_pid,
+				t_vars *vars);
 int			execute_pipeline(t_node *pipe_node, t_vars *vars);
 
+/*
+Pipe capacity handling.
+In pipe_size.c
+*/
+int			get_pipe_max_size(t_vars *vars);
+long		parse_pipe_size(const char *str);
+int			get_pipe_size(t_vars *vars);
+void		set_pipe_size(int *pipefd, t_vars *vars);
+
 /*
 Quote handling.
 In quotes.c
@@ -675,6 +1753,8 @@ int			input_redirect(t_node *node, int *fd_in, t_vars *vars);
 int			output_redirect(t_node *node, int *fd_out, int append, t_vars *vars);
 int			open_redirect_file(t_node *node, int *fd, int mode, t_vars *vars);
 int			handle_redirect(t_node *node, int *fd, int mode, t_vars *vars);
+int			open_builtin_redir(t_node *redir, t_io *io, t_vars *vars);
+int			exec_redirect_builtin(t_node *node, t_vars *vars);
 
 /*
 Shell level handling.
@@ -688,9 +1768,20 @@ int			incr_shell_level(t_vars *vars);
 Signal handling.
 In signals.c
 */
-void		load_signals(void);
+void		load_signals(t_vars *vars);
 void		sigint_handler(int sig);
-void		sigquit_handler(int sig);
+void		builtin_interrupts(int on);
+void		reset_child_signals(void);
+int			read_signals(t_vars *vars);
+void		handle_signals(t_vars *vars, int got);
+
+/*
+Speculative parsing.
+In speculate.c
+*/
+t_flatast	*spec_build(char *line, int *background, t_vars *vars);
+void		spec_parse(char *line, t_vars *vars);
+t_pcentry	*spec_take(t_pcache *cache, char *line, unsigned long hash);
 
 /*
 Token classification handling.
@@ -710,7 +1801,6 @@ Tokenizing functions.
 In tokenize.c
 */
 void		maketoken(char *token, t_vars *vars);
-t_node		*find_last_command(t_node *head);
 int			handle_expand(t_vars *vars);
 int			process_special_char(char *input, int *i, t_vars *vars);
 int			process_expand_char(char *input, int *i, t_vars *vars);
@@ -0,0 +1,86 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   arena.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/25 18:20:14 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/25 18:20:14 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Sets up an empty arena. Nothing is allocated until first use.
+Works with vm_run() and the tree-walking executors.
+*/
+void	arena_init(t_arena *arena)
+{
+	arena->buf = NULL;
+	arena->used = 0;
+	arena->cap = 0;
+}
+
+/*
+Empties the arena and makes sure one block holds size bytes.
+- Everything handed out before is released: the block is reused,
+  and only replaced when it is too small.
+- The block never moves while pointers into it are live, because it
+  is only resized here, when none are.
+Returns:
+1 on success, 0 on allocation failure.
+Works with expand_argv().
+*/
+int	arena_reserve(t_arena *arena, size_t size)
+{
+	size_t	cap;
+
+	arena->used = 0;
+	if (size <= arena->cap)
+		return (1);
+	cap = arena->cap * 2;
+	if (cap < ARENA_MIN)
+		cap = ARENA_MIN;
+	if (cap < size)
+		cap = size;
+	free(arena->buf);
+	arena->buf = malloc(cap);
+	if (!arena->buf)
+	{
+		arena->cap = 0;
+		return (0);
+	}
+	arena->cap = cap;
+	return (1);
+}
+
+/*
+Hands out the next size bytes of the arena, 8-byte aligned.
+Returns:
+Pointer into the arena, or NULL if it does not fit (the caller
+reserves the exact total first, so this means a sizing bug).
+Works with expand_argv().
+*/
+void	*arena_alloc(t_arena *arena, size_t size)
+{
+	void	*ptr;
+
+	size = (size + 7) & ~(size_t)7;
+	if (arena->used + size > arena->cap)
+		return (NULL);
+	ptr = arena->buf + arena->used;
+	arena->used += size;
+	return (ptr);
+}
+
+/*
+Releases the arena's block.
+Works with vm_run() and the tree-walking executors.
+*/
+void	arena_free(t_arena *arena)
+{
+	free(arena->buf);
+	arena_init(arena);
+}
@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/01 21:36:41 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 04:18:17 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/25 22:31:06 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -32,39 +32,38 @@ void	create_args_array(t_node *node, char *token)
 	}
 	args[1] = NULL;
 	node->args = args;
+	node->argc = 1;
+	node->arg_cap = 2;
 }
 
 /*
 Append a new argument to the node's argument array.
-Works like realloc for the array.
-Example: node->args is ["ls", "-l", NULL]
-After append_arg(node, "-a"), node->args becomes ["ls", "-l", "-a", NULL]
+- The array keeps spare slots (arg_cap) and doubles when full, so
+  appending n arguments costs O(n) in total instead of O(n^2).
+- On allocation failure args is left as it was.
+Works with maketoken() and build_cmdarg_node().
+
+Example: node->args is ["ls", NULL], arg_cap 2
+After append_arg(node, "-l"), node->args becomes ["ls", "-l", NULL] in a
+block of VEC_MIN slots, the next 13 appends reuse that block.
 */
 void	append_arg(t_node *node, char *new_arg)
 {
-    char	**new_args;
-    size_t	len;
-    size_t	i;
+	char	*arg;
 
-    if (!node || !new_arg || !node->args)
-        return ;
-    len = ft_arrlen(node->args);
-    new_args = malloc(sizeof(char *) * (len + 2));
-    if (!new_args)
-        return ;
-    i = -1;
-    while (++i < len)
-    {
-        new_args[i] = node->args[i];
-        if (!new_args[i])
-        {
-            free(new_args);
-            return ;
-        }
-    }
-    new_args[len] = ft_strdup(new_arg);
-    new_args[len + 1] = NULL;
-    process_quotes_in_arg(&new_args[len]);
-    free(node->args);
-    node->args = new_args;
+	if (!node || !new_arg || !node->args)
+		return ;
+	arg = ft_strdup(new_arg);
+	if (!arg)
+		return ;
+	if (!vec_reserve((void **)&node->args, &node->arg_cap,
+			node->argc + 2, sizeof(char *)))
+	{
+		free(arg);
+		return ;
+	}
+	node->args[node->argc] = arg;
+	node->args[node->argc + 1] = NULL;
+	process_quotes_in_arg(&node->args[node->argc]);
+	node->argc++;
 }
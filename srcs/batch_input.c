@@ -0,0 +1,287 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   batch_input.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/23 15:48:20 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/23 15:48:20 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Sets up batch input from a string, as given to -c.
+- The string is used in place and never freed.
+Works with setup_input().
+*/
+void	init_input_string(t_input *in, char *str)
+{
+	ft_memset(in, 0, sizeof(t_input));
+	in->mode = INPUT_BATCH;
+	in->fd = -1;
+	in->data = str;
+	in->len = ft_strlen(str);
+	in->eof = 1;
+}
+
+/*
+Sets up batch input from a file descriptor.
+- Regular files are mapped whole with mmap(), starting at the current
+  offset so "{ read x; bleshell; } < file" keeps working.
+- Pipes and other fds are read in BATCH_CHUNK sized blocks on demand.
+Returns:
+1 on success, 0 on allocation failure.
+Works with setup_input().
+*/
+int	init_input_fd(t_input *in, int fd)
+{
+	struct stat	st;
+	off_t		start;
+	void		*map;
+
+	ft_memset(in, 0, sizeof(t_input));
+	in->mode = INPUT_BATCH;
+	in->fd = fd;
+	start = lseek(fd, 0, SEEK_CUR);
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && start >= 0
+		&& st.st_size > start)
+	{
+		map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED)
+		{
+			madvise(map, st.st_size, MADV_SEQUENTIAL);
+			in->data = map;
+			in->len = st.st_size;
+			in->pos = start;
+			in->mapped = 1;
+			in->eof = 1;
+			return (1);
+		}
+	}
+	in->cap = BATCH_CHUNK;
+	in->data = malloc(in->cap);
+	return (in->data != NULL);
+}
+
+/*
+Opens a script file given on the command line.
+- Reports the error like bash and exits with 127 if it cannot be read.
+Works with setup_input().
+*/
+void	init_input_file(t_input *in, char *path)
+{
+	int	fd;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+	{
+		ft_putstr_fd("bleshell: ", 2);
+		ft_putstr_fd(path, 2);
+		ft_putstr_fd(": ", 2);
+		ft_putendl_fd(strerror(errno), 2);
+		exit(127);
+	}
+	if (!init_input_fd(in, fd))
+		exit(1);
+}
+
+/*
+Chooses where commands are read from, based on the arguments.
+- "bleshell -c 'cmd'": runs the string.
+- "bleshell script.sh": runs the file.
+- stdin not a terminal: runs stdin.
+- Otherwise: interactive readline mode.
+Works with main().
+*/
+void	setup_input(t_vars *vars, int argc, char **argv)
+{
+	if (argc >= 2 && ft_strcmp(argv[1], "-c") == 0)
+	{
+		if (argc < 3)
+		{
+			ft_putendl_fd("bleshell: -c: option requires an argument", 2);
+			exit(2);
+		}
+		init_input_string(&vars->input, argv[2]);
+	}
+	else if (argc >= 2)
+		init_input_file(&vars->input, argv[1]);
+	else if (!isatty(STDIN_FILENO))
+	{
+		if (!init_input_fd(&vars->input, STDIN_FILENO))
+			exit(1);
+	}
+	else
+		vars->input.mode = INPUT_TTY;
+}
+
+/*
+Reads the next block of a non-mapped batch input.
+- Moves the unread tail to the front of the buffer.
+- Doubles the buffer when a single line fills it.
+Returns:
+Number of bytes read, 0 at end of input, -1 on error.
+Works with batch_readline().
+*/
+ssize_t	batch_refill(t_input *in)
+{
+	char	*grown;
+	ssize_t	n;
+
+	if (in->pos > 0)
+	{
+		ft_memmove(in->data, in->data + in->pos, in->len - in->pos);
+		in->len -= in->pos;
+		in->pos = 0;
+	}
+	if (in->len == in->cap)
+	{
+		grown = malloc(in->cap * 2);
+		if (!grown)
+			return (-1);
+		ft_memcpy(grown, in->data, in->len);
+		free(in->data);
+		in->data = grown;
+		in->cap *= 2;
+	}
+	n = read(in->fd, in->data + in->len, in->cap - in->len);
+	while (n == -1 && errno == EINTR)
+		n = read(in->fd, in->data + in->len, in->cap - in->len);
+	if (n <= 0)
+		in->eof = 1;
+	else
+		in->len += n;
+	return (n);
+}
+
+/*
+Returns the next line of batch input, without readline.
+- Scans for the newline with memchr() over the buffered block.
+- The last line is returned even without a trailing newline.
+- For mapped stdin the file offset is kept in step both ways: commands
+  that read stdin start right after the current line, and whatever
+  they consume is not run as commands.
+Returns:
+Newly allocated line without the newline, or NULL at end of input.
+Works with shell_readline().
+*/
+char	*batch_readline(t_input *in)
+{
+	char	*nl;
+	char	*line;
+	size_t	len;
+	off_t	off;
+
+	nl = NULL;
+	if (in->mapped && in->fd == STDIN_FILENO)
+	{
+		off = lseek(in->fd, 0, SEEK_CUR);
+		if (off > (off_t)in->pos)
+			in->pos = off;
+	}
+	while (1)
+	{
+		if (in->pos < in->len)
+			nl = ft_memchr(in->data + in->pos, '\n', in->len - in->pos);
+		if (nl || in->eof)
+			break ;
+		if (batch_refill(in) < 0)
+			return (NULL);
+	}
+	if (in->pos >= in->len)
+		return (NULL);
+	len = in->len - in->pos;
+	if (nl)
+		len = nl - (in->data + in->pos);
+	line = ft_strndup(in->data + in->pos, len);
+	in->pos += len + (nl != NULL);
+	if (in->mapped && in->fd == STDIN_FILENO)
+		lseek(in->fd, in->pos, SEEK_SET);
+	return (line);
+}
+
+/*
+Checks if the batch input has nothing left to run.
+- Skips blank lines and whitespace after the current position.
+- Reads ahead on pipes when the buffer runs out.
+Returns:
+1 if only whitespace remains, 0 otherwise.
+Works with is_final_cmd().
+
+Example: bleshell -c "ls"
+- The whole string was consumed by the first read
+- Returns 1
+*/
+int	batch_is_last(t_input *in)
+{
+	size_t	i;
+
+	i = in->pos;
+	while (1)
+	{
+		while (i < in->len && ft_isspace(in->data[i]))
+			i++;
+		if (i < in->len)
+			return (0);
+		if (in->eof)
+			return (1);
+		i -= in->pos;
+		if (batch_refill(in) < 0)
+			return (0);
+		i += in->pos;
+	}
+}
+
+/*
+Reads one line of input for any prompt in the shell.
+- Interactive mode: readline through the event loop, with the prompt.
+- Batch mode: next line from the batch source, no prompt.
+- In batch mode a Ctrl+C received meanwhile ends the shell with 130,
+  like a non-interactive sh.
+- Counts the lines read, so callers can tell if a command line
+  pulled in continuation lines.
+Returns:
+Newly allocated line, or NULL at end of input.
+Works with reader() and every continuation prompt
+(quotes, pipes, heredocs).
+*/
+char	*shell_readline(const char *prompt, t_vars *vars)
+{
+	t_io	io;
+	char	*line;
+
+	if (vars->input.mode == INPUT_TTY)
+		line = event_readline(prompt, vars);
+	else
+	{
+		read_signals(vars);
+		if (g_signal_received)
+		{
+			vars->error_code = 130;
+			init_io(&io, STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO);
+			builtin_exit(NULL, vars, &io);
+		}
+		line = batch_readline(&vars->input);
+	}
+	if (line)
+		vars->input.lines++;
+	return (line);
+}
+
+/*
+Releases the batch input source.
+Works with cleanup_exit().
+*/
+void	free_input(t_input *in)
+{
+	if (in->mapped)
+		munmap(in->data, in->len);
+	else if (in->fd != -1 && in->data)
+		free(in->data);
+	if (in->fd > 2)
+		close(in->fd);
+	ft_memset(in, 0, sizeof(t_input));
+}
@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/14 16:36:32 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 11:59:19 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 19:41:03 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -16,8 +16,9 @@
 Collects and stores command nodes from the token list in vars->cmd_nodes.
 - Traverses linked list of tokens starting from vars->head.
 - Identifies command nodes (TYPE_CMD).
-- Stores them in vars->cmd_nodes array for easier reference.
+- Stores them in the vars->cmd_nodes vector for easier reference.
 - Updates vars->cmd_count with total count of commands found.
+- The vector grows as needed, so there is no limit on the count.
 Works with proc_token_list().
 */
 void	get_cmd_nodes(t_vars *vars)
@@ -30,12 +31,10 @@ void	get_cmd_nodes(t_vars *vars)
     current = vars->head;
     while (current)
     {
-        if (current->type == TYPE_CMD && vars->cmd_count < 100)
+        if (current->type == TYPE_CMD)
         {
-            vars->cmd_nodes[vars->cmd_count] = current;
-            vars->cmd_count++;
-            fprintf(stderr, "DEBUG: Added command node: '%s'\n",
-                current->args[0]);
+            if (!push_cmd_node(vars, current))
+                return ;
         }
         current = current->next;
     }
@@ -91,8 +90,6 @@ void	setup_first_pipe(t_node *pipe_node, t_node *prev_cmd, t_node *next_cmd)
         return ;
     pipe_node->left = prev_cmd;
     pipe_node->right = next_cmd;
-    fprintf(stderr, "DEBUG: Setting pipe root with left: %s\n",
-        prev_cmd->args[0]);
 }
 
 /*
@@ -111,8 +108,6 @@ void	setup_next_pipes(t_node *pipe_node, t_node *last_pipe,
     pipe_node->left = last_cmd;
     pipe_node->right = next_cmd;
     last_pipe->right = pipe_node;
-    fprintf(stderr, "DEBUG: Added additional pipe with left: %s\n",
-        last_cmd->args[0]);
 }
 
 /*
@@ -200,8 +195,6 @@ void	setup_redir_ast(t_node *redir, t_node *cmd, t_node *target)
         return ;
     redir->left = cmd;
     redir->right = target;
-    fprintf(stderr, "DEBUG: Created redirection from %s to %s\n",
-        cmd->args[0], target->args[0]);
 }
 
 /*
@@ -381,11 +374,9 @@ t_node	*proc_token_list(t_vars *vars)
 
     if (!vars || !vars->head)
     {
-        fprintf(stderr, "DEBUG: No tokens to process\n");
         return (NULL);
     }
     get_cmd_nodes(vars);
-    fprintf(stderr, "DEBUG: Processing token list for AST\n");
     pipe_root = proc_pipes_pt1(vars, &last_pipe, &last_cmd);
     proc_pipes_pt2(vars, pipe_root, &last_pipe, &last_cmd);
     redir_root = proc_redir_pt1(vars, pipe_root);
@@ -629,16 +620,12 @@ void convert_str_to_cmds(t_vars *vars)
             if (current->next->type == TYPE_STRING)
             {
                 current->next->type = TYPE_CMD;
-                fprintf(stderr, "DEBUG: Converting '%s' to command after pipe\n", 
-                        current->next->args[0]);
                 
                 // Check for argument after command
                 if (current->next->next && current->next->next->type == TYPE_STRING)
                 {
                     // Add string as arg to command
                     append_arg(current->next, current->next->next->args[0]);
-                    fprintf(stderr, "DEBUG: Adding '%s' as argument to '%s'\n",
-                            current->next->next->args[0], current->next->args[0]);
                             
                     // Remove the arg token from list
                     to_remove = current->next->next;
@@ -662,23 +649,12 @@ void setup_pipe_links(t_node *pipe_node, t_node *left_cmd, t_node *right_cmd)
     if (left_cmd)
     {
         pipe_node->left = left_cmd;
-        fprintf(stderr, "DEBUG: Setting pipe with left: %s\n",
-            left_cmd->args ? left_cmd->args[0] : "NULL");
     }
     // Connect right command
     if (right_cmd)
     {
         pipe_node->right = right_cmd;
-        fprintf(stderr, "DEBUG: Setting pipe's right to: %s\n",
-            right_cmd->args ? right_cmd->args[0] : "NULL");
     }
-    // Debug pipe connections
-    fprintf(stderr, "DEBUG: Pipe node %p: left=%p (%s), right=%p (%s)\n",
-        (void*)pipe_node, 
-        (void*)pipe_node->left,
-        pipe_node->left && pipe_node->left->args ? pipe_node->left->args[0] : "NULL",
-        (void*)pipe_node->right,
-        pipe_node->right && pipe_node->right->args ? pipe_node->right->args[0] : "NULL");
 }
 
 /*
@@ -698,8 +674,6 @@ void convert_strs_to_cmds(t_vars *vars)
         {
             // Convert string to command
             current->next->type = TYPE_CMD;
-            fprintf(stderr, "DEBUG: Converting '%s' to command after pipe\n", 
-                    current->next->args[0]);
         }
         current = current->next;
     }
@@ -755,8 +729,6 @@ void handle_quoted_arg(t_node *cmd_node, t_node *quote_token)
     
     // Add quoted content as argument to command
     append_arg(cmd_node, arg_content);
-    fprintf(stderr, "DEBUG: Adding quoted argument '%s' to '%s'\n",
-            arg_content, cmd_node->args[0]);
 }
 
 /*
@@ -865,8 +837,6 @@ void	link_strargs_to_cmds(t_vars *vars)
                  is_special_token(current)) && cmd_node)
         {
             append_arg(cmd_node, current->args[0]);
-            fprintf(stderr, "DEBUG: Adding '%s' as argument to '%s'\n",
-                    current->args[0], cmd_node->args[0]);
             del_list_node(current);
             free_token_node(current);
         }
@@ -929,8 +899,6 @@ void build_pipe_ast(t_vars *vars)
         if (current->type == TYPE_CMD)
         {
             cmd_before = current;
-            fprintf(stderr, "DEBUG: Added command node: '%s'\n", 
-                current->args ? current->args[0] : "NULL");
         }
         // Process pipe nodes
         else if (current->type == TYPE_PIPE)
@@ -950,14 +918,12 @@ void build_pipe_ast(t_vars *vars)
                     vars->astroot->right = cmd_after;
                 
                 last_pipe = vars->astroot;
-                debug_print_pipe_info(vars->astroot, "First pipe");
             }
             // Process additional pipes
             else if (last_pipe)
             {
                 link_addon_pipe(last_pipe, current, cmd_after);
                 last_pipe = current;
-                debug_print_pipe_info(current, "Added pipe");
             }
         }
         
@@ -970,8 +936,6 @@ void build_pipe_ast(t_vars *vars)
         if (vars->head && vars->head->type == TYPE_CMD)
         {
             vars->astroot = vars->head;
-            fprintf(stderr, "DEBUG: No pipes - setting root to command: %s\n",
-                vars->head->args ? vars->head->args[0] : "NULL");
         }
     }
 }
@@ -982,13 +946,9 @@ Processes token list to build the AST structure.
 - Links string arguments to appropriate commands
 - Builds the AST structure for pipes and commands
 - Sets the root node of the AST
-Debug output helps trace the AST building process.
 */
 void process_token_list(t_vars *vars)
 {
-    // Debug message
-    fprintf(stderr, "DEBUG: Processing token list for AST\n");
-    
     // Step 1: Convert strings after pipes to commands
     convert_strs_to_cmds(vars);
     
@@ -998,13 +958,81 @@ void process_token_list(t_vars *vars)
     // Step 3: Build the pipe structure
     build_pipe_ast(vars);
     
-    // Output debug information
-    if (vars->astroot)
+    // Step 4: Wrap commands in their redirections
+    link_redirs_to_cmds(vars);
+}
+
+/*
+Puts a chain of redirections in place of the command they wrap.
+- The first redirection becomes the node the parent pipe points at.
+- If the command was the AST root (or there is none yet),
+  the redirection becomes the root.
+Works with link_redirs_to_cmds().
+*/
+void	wrap_redir_segment(t_vars *vars, t_node *cmd, t_node *first)
+{
+    if (!cmd || !first)
+        return ;
+    if (!vars->astroot || vars->astroot == cmd)
+        vars->astroot = first;
+    else
+        upd_pipe_redir(vars->astroot, cmd, first);
+}
+
+/*
+Links redirection tokens into the AST around their commands.
+- Works one pipeline segment at a time (between pipe tokens).
+- Each redirection takes the following token as its target file.
+- Redirections chain through their left child in command-line order,
+  the innermost left child being the command itself.
+- Redirections before the command name are handled the same way.
+Works with process_token_list().
+
+Example: For "echo hi > a >> b | wc"
+- '>' gets left = '>>', right = "a"
+- '>>' gets left = echo, right = "b"
+- Pipe left becomes '>' instead of echo
+*/
+void	link_redirs_to_cmds(t_vars *vars)
+{
+    t_node	*current;
+    t_node	*cmd;
+    t_node	*first;
+    t_node	*last;
+
+    current = vars->head;
+    cmd = NULL;
+    first = NULL;
+    last = NULL;
+    while (current)
     {
-        fprintf(stderr, "DEBUG: Built AST successfully\n");
-        fprintf(stderr, "DEBUG: Root command: %s\n", 
-            get_token_str(vars->astroot->type));
+        if (current->type == TYPE_PIPE)
+        {
+            if (last)
+                last->left = cmd;
+            wrap_redir_segment(vars, cmd, first);
+            cmd = NULL;
+            first = NULL;
+            last = NULL;
+        }
+        else if (current->type == TYPE_CMD && !cmd)
+            cmd = current;
+        else if (is_redir_token(current->type) && current->next
+            && current->next->args && current->next->type != TYPE_PIPE)
+        {
+            if (!first)
+                first = current;
+            else
+                last->left = current;
+            last = current;
+            current->right = current->next;
+            current = current->next;
+        }
+        current = current->next;
     }
+    if (last)
+        last->left = cmd;
+    wrap_redir_segment(vars, cmd, first);
 }
 
 /*
@@ -1166,184 +1194,15 @@ t_node	*set_ast_root(t_node *pipe_node, t_vars *vars)
 {
     if (pipe_node)
     {
-        fprintf(stderr, "DEBUG: Built AST successfully with root type %d\n",
-            pipe_node->type);
         return (pipe_node);
     }
     if (vars->cmd_count > 0)
     {
-        fprintf(stderr, "DEBUG: Built AST with single command\n");
         return (vars->cmd_nodes[0]);
     }
-    fprintf(stderr, "DEBUG: No valid nodes found for AST\n");
     return (NULL);
 }
 
-/*
-Detects if a pipe token appears at the beginning of input.
-- Checks if the first token is a pipe (syntax error).
-- Sets error code and outputs error message if detected.
-Returns:
-- 1 if pipe found at beginning (error condition).
-- 0 if no error detected or no tokens exist.
-Works with chk_pipe_syntax_err().
-*/
-int	chk_start_pipe(t_vars *vars)
-{
-    if (!vars || !vars->head)
-        return (0);
-    if (vars->head->type == TYPE_PIPE)
-    {
-        fprintf(stderr, "DEBUG: Error: Pipe at start of input\n");
-        ft_putstr_fd("bleshell: unexpected syntax error at '|'\n", 2);
-        vars->error_code = 258;
-        return (1);
-    }
-    return (0);
-}
-
-/*
-Detects multiple pipe tokens in sequence.
-- Tracks count of consecutive pipe tokens.
-- Reports syntax error if multiple pipes are detected.
-- Sets error code and outputs error message.
-Returns:
-- 1 if consecutive pipes detected (error).
-- 0 if no consecutive pipes.
-Works with chk_next_pipes().
-*/
-int	detect_multi_pipes(t_vars *vars, int pipes_count)
-{
-    if (pipes_count > 1)
-    {
-        fprintf(stderr, "DEBUG: Error: Multiple consecutive pipes\n");
-        ft_putstr_fd("bleshell: syntax error near unexpected token '|'\n", 2);
-        vars->error_code = 258;
-        return (1);
-    }
-    return (0);
-}
-
-/*
-Detects adjacent pipe tokens in the list.
-- Checks if current and next token are both pipes.
-- Reports syntax error if adjacent pipes are detected.
-- Sets error code and outputs error message.
-Returns:
-- 1 if adjacent pipes detected (error).
-- 0 if no adjacent pipes.
-Works with chk_next_pipes().
-*/
-int	detect_adj_pipes(t_vars *vars, t_node *current)
-{
-    if (current->next && current->next->type == TYPE_PIPE)
-    {
-        fprintf(stderr, "DEBUG: Error: Adjacent pipe tokens\n");
-        ft_putstr_fd("bleshell: syntax error near unexpected token '|'\n", 2);
-        vars->error_code = 258;
-        return (1);
-    }
-    return (0);
-}
-
-/*
-Checks for consecutive pipe tokens in the token list.
-- Tracks sequence of pipe tokens.
-- Reports syntax error if multiple pipes found consecutively.
-Returns:
-- 1 if pipe syntax error found.
-- 0 if no errors detected.
-Works with chk_pipe_syntax_err().
-*/
-int	chk_next_pipes(t_vars *vars)
-{
-    t_node	*current;
-    int		multi_pipes;
-    int		error;
-
-    current = vars->head;
-    multi_pipes = 0;
-    while (current)
-    {
-        if (current->type == TYPE_PIPE)
-        {
-            multi_pipes++;
-            error = detect_multi_pipes(vars, multi_pipes);
-            if (error)
-                return (error);
-            error = detect_adj_pipes(vars, current);
-			fprintf(stderr, "DEBUG: Returning error in chk_next_pipes\n");
-            if (error)
-                return (error);
-        }
-        else
-            multi_pipes = 0;
-        current = current->next;
-    }
-    return (0);
-}
-
-/*
-Detects if a pipe token appears at the end of input.
-- Checks if the last token is a pipe.
-- Indicates more input is needed to complete command.
-Returns:
-- 2 if pipe found at end (requires more input).
-- 0 if no pipe at end or no tokens exist.
-Works with chk_pipe_syntax_err().
-*/
-int	chk_end_pipe(t_vars *vars)
-{
-    t_node	*current;
-
-    current = vars->head;
-    while (current && current->next)
-        current = current->next;
-    if (current && current->type == TYPE_PIPE)
-    {
-        fprintf(stderr, "DEBUG: Pipe at end of input, need more input\n");
-        return (2);
-    }
-    return (0);
-}
-
-/*
-Performs comprehensive check of pipe syntax in token list.
-- Detects pipes at beginning (error).
-- Detects consecutive pipes (error).
-- Detects pipes at end (needs more input).
-Returns:
-- 0 if pipe syntax is valid.
-- 1 if syntax error detected.
-- 2 if more input needed (pipe at end).
-Works with handle_incomplete_pipe().
-
-Example: For input "| ls":
-- Returns 1 (error: pipe at beginning)
-For input "ls | grep a |":
-- Returns 2 (needs more input)
-*/
-int	chk_pipe_syntax_err(t_vars *vars)
-{
-    int	result;
-
-    if (!vars->head)
-    {
-        fprintf(stderr, "DEBUG: No tokens to check pipe syntax\n");
-        return (0);
-    }
-    result = chk_start_pipe(vars);
-    if (result != 0)
-        return (result);
-    result = chk_next_pipes(vars);
-    if (result != 0)
-        return (result);
-    result = chk_end_pipe(vars);
-    if (result != 0)
-        return (result);
-    return (0);
-}
-
 /*
 Combines original input with new input line.
 - Joins strings with a space separator.
@@ -1434,7 +1293,7 @@ char *handle_trailing_pipe_pt2(char *new_input, t_vars *vars)
     fprintf(stderr, "DEBUG: [handle_trailing_pipe_pt2] Starting with new_input=%p: '%s'\n", 
             (void*)new_input, new_input);
     
-    line = readline("COMMAND> ");
+    line = shell_readline("COMMAND> ", vars);
     if (!line)
     {
         fprintf(stderr, "DEBUG: [handle_trailing_pipe_pt2] readline returned NULL, freeing new_input=%p\n", 
@@ -1538,9 +1397,9 @@ char *handle_incomplete_pipe(char *input, t_vars *vars)
             return (NULL);
         }
         
-        int check_result = chk_pipe_syntax_err(vars);
+        int check_result = chk_syntax(vars);
         fprintf(stderr, "DEBUG: [handle_incomplete_pipe] Pipe syntax check: %d\n", check_result);
-        if (check_result != 2)
+        if (check_result != SYNTAX_MORE_PIPE)
             continue_prompting = 0;
     }
     
@@ -1570,10 +1429,8 @@ t_node *build_ast(t_vars *vars)
 {
     t_node *root;
 
-    fprintf(stderr, "DEBUG: Building AST for commands and redirections\n");
     if (!vars || !vars->head)
     {
-        fprintf(stderr, "DEBUG: No tokens (vars->head is NULL)!\n");
         return (NULL);
     }
     get_cmd_nodes(vars);
@@ -1582,11 +1439,8 @@ t_node *build_ast(t_vars *vars)
     if (!root && vars->cmd_count > 0)
     {
         root = vars->cmd_nodes[0];
-        fprintf(stderr, "DEBUG: Using first command as root: %s\n",
-            root->args ? root->args[0] : "NULL");
         vars->astroot = root;
     }
-    debug_print_token_list(vars);
     return root;
 }
 
@@ -1622,7 +1476,7 @@ Prints complete token list for debugging purposes.
 - Outputs each token with its attributes.
 - Shows token indices for reference.
 - Formats output with clear start and end markers.
-Works with build_ast() for debugging.
+Works with process_command() for debugging.
 */
 void	debug_print_token_list(t_vars *vars)
 {
@@ -1643,62 +1497,6 @@ void	debug_print_token_list(t_vars *vars)
     fprintf(stderr, "=== END TOKEN LIST ===\n\n");
 }
 
-/*
-Check if the first token in the list is a pipe (syntax error).
-Code 258 is the standard code used for syntax errors.
-Returns:
-0 - no pipe at beginning
-1 - pipe at beginning (sets error code)
-*/
-int	check_initial_pipe(t_vars *vars, t_ast *ast)
-{
-	if (!vars || !vars->head || !ast)
-		return (0);       
-	// Check if the first token is a pipe
-	if (vars->head->type == TYPE_PIPE)
-	{
-		fprintf(stderr, "DEBUG: Syntax error: pipe at beginning\n");
-		if (vars->pipeline)
-			vars->pipeline->last_cmdcode = 258;
-		ast->pipe_at_front = 1;
-		ast->syntax_error = 1;
-		return (1);
-	}
-	return (0);
-}
-
-/*
-Check for initial/consecutive pipe syntax errors.
-Returns:
-0 - no initial/consecutive pipe errors
-1 - found syntax error (sets error code)
-*/
-int	check_bad_pipe_series(t_vars *vars)
-{
-	int		result;
-	t_ast	*ast;
-	
-	ast = init_ast_struct();
-	if (!ast)
-		return (0);
-	// First check for a pipe at the beginning
-	result = check_initial_pipe(vars, ast);
-	if (result != 0)
-	{
-		cleanup_ast_struct(ast);
-		return (result);
-	}
-	// Then check for consecutive pipes
-	result = chk_serial_pipes(vars, ast);
-	if (result != 0)
-	{
-		cleanup_ast_struct(ast);
-		return (result);
-	}
-	cleanup_ast_struct(ast);
-	return (0);
-}
-
 /*
 Builds an AST from the token linked list in vars.
 This is a sub-control function for the AST building process by:
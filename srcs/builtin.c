@@ -6,16 +6,104 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/01 23:33:49 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/19 18:01:10 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 14:40:22 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../includes/minishell.h"
 
+/*
+Computes the dispatch table slot for a command name.
+- Mixes the name length with its first and last characters.
+- Constants are chosen so every builtin name lands in its own slot.
+- Stops scanning early once the name is longer than any builtin.
+Returns:
+Slot index in range 0 to BUILTIN_SLOTS - 1.
+-1 if the name cannot be a builtin (empty or too long).
+Works with get_builtin().
+
+Example: builtin_hash("cd")
+- len=2, first='c' (99), last='d' (100)
+- (2 + 99 + 1200) & 31 = 21
+*/
+int	builtin_hash(const char *name)
+{
+	int	len;
+
+	if (!name || !name[0])
+		return (-1);
+	len = 0;
+	while (name[len])
+	{
+		len++;
+		if (len > BUILTIN_NAME_MAX)
+			return (-1);
+	}
+	return ((len + (unsigned char)name[0]
+			+ 12 * (unsigned char)name[len - 1]) & (BUILTIN_SLOTS - 1));
+}
+
+/*
+Returns the builtin dispatch table.
+- Laid out at compile time by builtin_hash() slot.
+- BUILTIN_SLOTS entries, empty slots have a NULL name.
+Works with get_builtin() and path_index_build().
+*/
+const t_builtin	*builtin_table(void)
+{
+	static const t_builtin	table[BUILTIN_SLOTS] = {
+	[1] = {"xargs", builtin_xargs, 0, 1},
+	[3] = {"pwd", builtin_pwd, 1, 0},
+	[8] = {"parallel", builtin_parallel, 0, 1},
+	[10] = {"unset", builtin_unset, 0, 0},
+	[11] = {"wait", builtin_wait, 0, 0},
+	[16] = {"env", builtin_env, 1, 0},
+	[18] = {"jobs", builtin_jobs, 1, 0},
+	[19] = {"tee", builtin_tee, 0, 1},
+	[21] = {"cd", builtin_cd, 0, 0},
+	[22] = {"cat", builtin_cat, 0, 1},
+	[24] = {"bg", builtin_bg, 0, 0},
+	[25] = {"exit", builtin_exit, 0, 0},
+	[27] = {"export", builtin_export, 0, 0},
+	[28] = {"fg", builtin_fg, 0, 0},
+	[29] = {"echo", builtin_echo, 1, 0},
+	};
+
+	return (table);
+}
+
+/*
+Looks up the descriptor for a builtin command.
+- Table comes from builtin_table().
+- One hash and one string compare per lookup.
+Returns:
+Pointer to the builtin descriptor.
+NULL if the command is not a builtin.
+Works with is_builtin(), execute_builtin() and exec_std_cmd().
+
+Example: get_builtin("echo")
+- Hashes to slot 29
+- Confirms slot name is "echo"
+- Returns {"echo", builtin_echo, 1, 0}
+*/
+const t_builtin	*get_builtin(const char *cmd)
+{
+	const t_builtin	*table;
+	int				slot;
+
+	slot = builtin_hash(cmd);
+	if (slot < 0)
+		return (NULL);
+	table = builtin_table();
+	if (!table[slot].name || ft_strcmp(table[slot].name, cmd) != 0)
+		return (NULL);
+	return (&table[slot]);
+}
+
 /*
 Checks if a command is a shell builtin.
-- Tests command name against all builtin commands.
-- Shell builtins: echo, cd, pwd, export, unset, env, exit.
+- Shell builtins: echo, cd, pwd, export, unset, env, exit, cat, tee,
+  jobs, wait, fg, bg, parallel, xargs.
 Returns:
 1 if command is a builtin.
 0 if command is not a builtin or is NULL.
@@ -23,56 +111,60 @@ Works with execute_builtin().
 */
 int	is_builtin(char *cmd)
 {
-    if (!cmd)
-        return (0);
-    if (!ft_strcmp(cmd, "cd"))
-        return (1);
-    if (!ft_strcmp(cmd, "echo"))
-        return (1);
-    if (!ft_strcmp(cmd, "env"))
-        return (1);
-    if (!ft_strcmp(cmd, "exit"))
-        return (1);
-    if (!ft_strcmp(cmd, "export"))
-        return (1);
-    if (!ft_strcmp(cmd, "pwd"))
-        return (1);
-    if (!ft_strcmp(cmd, "unset"))
-        return (1);
-    return (0);
+	return (get_builtin(cmd) != NULL);
 }
 
 /*
 Executes the appropriate builtin command function.
-- Identifies which builtin to call based on command name.
-- Passes arguments and environment to the specific builtin.
+- Resolves the handler with a single table lookup.
 - Each builtin handles its own error messages and reporting.
+- All output goes through io, so redirections never touch stdio.
 Returns:
 The exit status from the executed builtin.
 1 if command is invalid (should never happen).
-Works with handle_builtin_cmd().
+Works with exec_redirect_builtin().
 
 Example: For "cd /home"
-- Calls builtin_cd() with args={"cd", "/home"} and vars
+- Calls builtin_cd() with args={"cd", "/home"}, vars and io
 - Returns status code (0 for success, non-zero for error)
 */
-int	execute_builtin(char *cmd, char **args, t_vars *vars)
+int	execute_builtin(char *cmd, char **args, t_vars *vars, t_io *io)
 {
-    fprintf(stderr, "DEBUG: execute_builtin called with cmd: %s\n", cmd);
-    
-    if (!ft_strcmp(cmd, "cd"))
-        return (builtin_cd(args, vars));
-    if (!ft_strcmp(cmd, "echo"))
-        return (builtin_echo(args, vars));
-    if (!ft_strcmp(cmd, "env"))
-        return (builtin_env(vars));
-    if (!ft_strcmp(cmd, "exit"))
-        return (builtin_exit(vars));
-    if (!ft_strcmp(cmd, "export"))
-        return (builtin_export(args, vars));
-    if (!ft_strcmp(cmd, "pwd"))
-        return (builtin_pwd(vars));
-    if (!ft_strcmp(cmd, "unset"))
-        return (builtin_unset(args, vars));
-    return (1);
+	const t_builtin	*builtin;
+
+	builtin = get_builtin(cmd);
+	if (!builtin)
+		return (1);
+	return (builtin->fn(args, vars, io));
+}
+
+/*
+Checks if a pipeline stage can run inside the current process.
+- Unwraps output redirections (> and >>) around the command.
+- Command must be a builtin flagged as safe to run in the parent.
+- Builtins that read stdin are excluded since the pipe read end
+  would have to replace the shell's stdin.
+Returns:
+1 if the stage can skip the fork.
+0 if it must run in a child process.
+Works with execute_pipeline().
+
+Example: For "ls | echo done > log"
+- Right stage is an output redirection around "echo"
+- echo is flagged in_parent and does not need stdin
+- Returns 1, so echo runs without a fork
+*/
+int	is_parent_builtin_stage(t_node *node)
+{
+	const t_builtin	*builtin;
+
+	while (node && (node->type == TYPE_OUT_REDIRECT
+			|| node->type == TYPE_APPEND_REDIRECT))
+		node = node->left;
+	if (!node || node->type != TYPE_CMD || !node->args)
+		return (0);
+	builtin = get_builtin(node->args[0]);
+	if (!builtin || !builtin->in_parent || builtin->needs_stdin)
+		return (0);
+	return (1);
 }
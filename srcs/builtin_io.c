@@ -0,0 +1,128 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   builtin_io.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/22 10:14:27 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/22 10:14:27 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Initializes a builtin I/O context.
+- Records the descriptors the builtin must use for in/out/err.
+- Empties the output buffer.
+Works with exec_std_cmd() and exec_redirect_builtin().
+
+Example: For "echo hi > file"
+- init_io(&io, STDIN_FILENO, file_fd, STDERR_FILENO)
+- echo writes into io instead of the shell's stdout
+*/
+void	init_io(t_io *io, int in, int out, int err)
+{
+	io->in = in;
+	io->out = out;
+	io->err = err;
+	io->len = 0;
+	io->failed = 0;
+}
+
+/*
+Writes all buffered output to the output descriptor.
+- Empties the buffer even if the write fails.
+- A failed context (e.g. EPIPE) stays failed.
+Returns:
+0 on success, -1 on write failure.
+Works with io_write() and callers finishing a builtin.
+*/
+int	io_flush(t_io *io)
+{
+	int	len;
+
+	len = io->len;
+	io->len = 0;
+	if (len == 0)
+		return (-(io->failed));
+	return (io_write_direct(io, io->buf, len));
+}
+
+/*
+Writes a chunk straight to the output descriptor, bypassing the buffer.
+- Retries partial and interrupted writes.
+- Marks the context as failed on write errors.
+Returns:
+0 on success, -1 on write failure.
+Works with io_write() for chunks larger than the buffer.
+*/
+int	io_write_direct(t_io *io, const char *str, size_t len)
+{
+	ssize_t	ret;
+
+	while (len > 0 && !io->failed)
+	{
+		ret = write(io->out, str, len);
+		if (ret == -1 && errno == EINTR)
+			continue ;
+		if (ret <= 0)
+			io->failed = 1;
+		else
+		{
+			str += ret;
+			len -= ret;
+		}
+	}
+	if (io->failed)
+		return (-1);
+	return (0);
+}
+
+/*
+Appends bytes to the output buffer.
+- Flushes when the buffer would overflow.
+- Chunks larger than the buffer are written directly.
+Returns:
+0 on success, -1 on write failure.
+Works with io_putstr() and io_putendl().
+*/
+int	io_write(t_io *io, const char *str, size_t len)
+{
+	if (io->failed)
+		return (-1);
+	if (io->len + len > IO_BUF_SZ && io_flush(io) == -1)
+		return (-1);
+	if (len > IO_BUF_SZ)
+		return (io_write_direct(io, str, len));
+	ft_memcpy(io->buf + io->len, str, len);
+	io->len += len;
+	return (0);
+}
+
+/*
+Appends a string to the output buffer.
+Returns:
+0 on success, -1 on write failure.
+Works with builtins in place of printf() and ft_putstr_fd().
+*/
+int	io_putstr(t_io *io, const char *str)
+{
+	if (!str)
+		return (0);
+	return (io_write(io, str, ft_strlen(str)));
+}
+
+/*
+Appends a string followed by a newline to the output buffer.
+Returns:
+0 on success, -1 on write failure.
+Works with builtins in place of printf("%s\n").
+*/
+int	io_putendl(t_io *io, const char *str)
+{
+	if (io_putstr(io, str) == -1)
+		return (-1);
+	return (io_write(io, "\n", 1));
+}
@@ -0,0 +1,176 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   builtin_cat.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/23 11:05:12 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:55:37 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Prints a cat/tee error message to the builtin's error descriptor.
+- Format: "name: file: reason".
+Returns 1 so callers can use it as the command status.
+Works with builtin_cat() and builtin_tee().
+*/
+int	copy_error(const char *cmd, const char *file, const char *msg,
+		t_io *io)
+{
+	ft_putstr_fd((char *)cmd, io->err);
+	ft_putstr_fd(": ", io->err);
+	ft_putstr_fd((char *)file, io->err);
+	ft_putstr_fd(": ", io->err);
+	ft_putendl_fd((char *)msg, io->err);
+	return (1);
+}
+
+/*
+Checks that a cat/tee call only uses options the builtin implements.
+- Any word starting with '-' counts as an option, except "-" itself
+  (standard input for cat).
+- The first word may be one of the options in known, e.g. "-a" for
+  tee. Everything else ("-n", "--", "--help") is not supported.
+Returns:
+1 if the builtin can run the call, 0 if it must go to the system
+program.
+Works with builtin_cat() and builtin_tee().
+*/
+int	copy_supported(char **args, const char *known)
+{
+	int	i;
+
+	i = 1;
+	if (known && args[1] && ft_strcmp(args[1], known) == 0)
+		i++;
+	while (args[i])
+	{
+		if (args[i][0] == '-' && args[i][1])
+			return (0);
+		i++;
+	}
+	return (1);
+}
+
+/*
+Runs the system's cat or tee for a call the builtin cannot handle.
+- The program is looked up through PATH only, so the builtin is not
+  found again.
+- It runs with the builtin's descriptors as stdin, stdout and stderr,
+  and joins the foreground job like any other command.
+Returns:
+The program's exit status, 127 if it is not in PATH.
+Works with builtin_cat() and builtin_tee().
+
+Example: "cat -n notes.txt > out"
+- -n is not implemented, so /usr/bin/cat runs with io->out as stdout
+*/
+int	copy_external(char **args, t_vars *vars, t_io *io)
+{
+	char	*path;
+	pid_t	pid;
+	int		status;
+
+	path = get_cmd_path(args[0], vars->env, vars);
+	if (!path)
+		return (copy_error("bleshell", args[0], "command not found", io)
+			+ 126);
+	pid = fork();
+	if (pid == 0)
+	{
+		join_job_pgrp(vars, 1);
+		reset_child_signals();
+		if (io->in != STDIN_FILENO)
+			dup2(io->in, STDIN_FILENO);
+		if (io->out != STDOUT_FILENO)
+			dup2(io->out, STDOUT_FILENO);
+		if (io->err != STDERR_FILENO)
+			dup2(io->err, STDERR_FILENO);
+		execve(path, args, vars->env);
+		perror("bleshell");
+		exit(126);
+	}
+	track_job_pgrp(vars, pid, 1);
+	free(path);
+	if (pid < 0)
+		return (copy_error("bleshell", "fork", strerror(errno), io));
+	while (waitpid(pid, &status, 0) == -1 && errno == EINTR)
+		;
+	if (WIFSIGNALED(status))
+		return (128 + WTERMSIG(status));
+	return (WEXITSTATUS(status));
+}
+
+/*
+Copies one cat operand to the output.
+- "-" stands for the builtin's input descriptor.
+- Refuses to copy a file onto itself.
+Returns:
+0 on success, 1 on error (already reported), 130 if Ctrl+C
+interrupted the copy (EINTR, see builtin_interrupts()).
+Works with builtin_cat().
+*/
+int	cat_file(const char *file, t_io *io)
+{
+	int	fd;
+	int	ret;
+
+	fd = io->in;
+	if (ft_strcmp(file, "-") != 0)
+		fd = open(file, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return (copy_error("cat", file, strerror(errno), io));
+	if (is_same_file(fd, io->out))
+		ret = copy_error("cat", file, "input file is output file", io);
+	else if (copy_fd(fd, io->out) == 0)
+		ret = 0;
+	else if (errno == EINTR)
+		ret = 128 + SIGINT;
+	else
+		ret = copy_error("cat", file, strerror(errno), io);
+	if (fd != io->in)
+		close(fd);
+	return (ret);
+}
+
+/*
+Built-in command: cat. Concatenates files to standard output.
+- With no operands, copies standard input.
+- Data is moved by copy_fd(), so no bytes pass through the shell
+  when the kernel supports it.
+- Takes no options: a call with any goes to the system cat.
+- Ctrl+C stops it before the next operand.
+Returns:
+0 if every file was copied, 1 if any failed, 130 if interrupted.
+
+Example: "cat a.txt - b.txt"
+- Copies a.txt, then standard input, then b.txt
+*/
+int	builtin_cat(char **args, t_vars *vars, t_io *io)
+{
+	int	i;
+	int	ret;
+	int	cmdcode;
+
+	io_flush(io);
+	if (!copy_supported(args, NULL))
+		return (copy_external(args, vars, io));
+	if (!args[1])
+		return (cat_file("-", io));
+	cmdcode = 0;
+	i = 1;
+	while (args[i])
+	{
+		ret = cat_file(args[i], io);
+		if (ret == 128 + SIGINT)
+			return (ret);
+		if (ret)
+			cmdcode = 1;
+		i++;
+	}
+	return (cmdcode);
+}
@@ -21,7 +21,7 @@ Built-in command: cd. Changes the current working directory.
 - Frees memory allocated for oldpwd.
 Returns 0 on success, 1 on failure.
 */
-int	builtin_cd(char **args, t_vars *vars)
+int	builtin_cd(char **args, t_vars *vars, t_io *io)
 {
 	char	*oldpwd;
 	int		cmdcode;
@@ -29,10 +29,10 @@ int	builtin_cd(char **args, t_vars *vars)
 	oldpwd = ft_strdup(get_env_val("OLDPWD", vars->env));
 	if (!oldpwd)
 	{
-		printf("cd: ft_strdup error\n");
+		ft_putstr_fd("cd: ft_strdup error\n", io->err);
 		return (1);
 	}
-	cmdcode = handle_cd_path(args, vars);
+	cmdcode = handle_cd_path(args, vars, io);
 	if (cmdcode != 0)
 	{
 		ft_safefree((void **)&oldpwd);
@@ -57,7 +57,7 @@ Handle changing to special directories (home or previous).
 - Gets the path from the environment variables.
 Returns 0 on success, 1 on failure.
 */
-int	handle_cd_special(char **args, t_vars *vars)
+int	handle_cd_special(char **args, t_vars *vars, t_io *io)
 {
 	char	*path_value;
 	int		cmdcode;
@@ -68,7 +68,7 @@ int	handle_cd_special(char **args, t_vars *vars)
 		cmdcode = chdir(path_value);
 		if (cmdcode != 0)
 		{
-			printf("cd: HOME not set or no access\n");
+			ft_putstr_fd("cd: HOME not set or no access\n", io->err);
 			return (1);
 		}
 		return (0);
@@ -77,10 +77,10 @@ int	handle_cd_special(char **args, t_vars *vars)
 	cmdcode = chdir(path_value);
 	if (cmdcode != 0)
 	{
-		printf("cd: OLDPWD not set or no access\n");
+		ft_putstr_fd("cd: OLDPWD not set or no access\n", io->err);
 		return (1);
 	}
-	printf("%s\n", path_value);
+	io_putendl(io, path_value);
 	return (0);
 }
 
@@ -90,19 +90,20 @@ Handle directory change based on arguments.
 - Prints error message if directory does not exist.
 Returns 0 on success, 1 on failure.
 */
-int	handle_cd_path(char **args, t_vars *vars)
+int	handle_cd_path(char **args, t_vars *vars, t_io *io)
 {
 	int	cmdcode;
 	
 	if ((!args[1]) || ((args[1][0] == '~') && (args[1][1] == '\0')) ||
 		(args[1][0] == '-' && args[1][1] == '\0'))
 	{
-		return (handle_cd_special(args, vars));
+		return (handle_cd_special(args, vars, io));
 	}
 	cmdcode = chdir(args[1]);
 	if (cmdcode != 0)
 	{
-		printf("cd: no such file or directory: %s\n", args[1]);
+		ft_putstr_fd("cd: no such file or directory: ", io->err);
+		ft_putendl_fd(args[1], io->err);
 		return (1);
 	}
 	return (0);
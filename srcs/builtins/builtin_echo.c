@@ -19,7 +19,7 @@ Built-in command: echo. Writes arguments to standard output.
    (Normally a newline is printed at the end of the echo command)
 Returns command status (0 for success, 1 for failure).
 */
-int	builtin_echo(char **args, t_vars *vars)
+int	builtin_echo(char **args, t_vars *vars, t_io *io)
 {
 	int	i;
 	int	newline;
@@ -40,7 +40,7 @@ int	builtin_echo(char **args, t_vars *vars)
 		newline = 0;
 		i++;
 	}
-	process_echo_args(args, i, newline);
+	process_echo_args(args, i, newline, io);
 	if (vars->pipeline != NULL)
 		vars->pipeline->last_cmdcode = cmdcode;
 	return (cmdcode);
@@ -50,27 +50,22 @@ int	builtin_echo(char **args, t_vars *vars)
 Process and print echo command arguments.
 Adds a space after each argument if there is more than one argument.
 Adds newline if needed.
+Output is buffered in the I/O context and written once at the end.
 Returns 0 on success.
 */
-int process_echo_args(char **args, int start, int nl_flag)
+int process_echo_args(char **args, int start, int nl_flag, t_io *io)
 {
 	int i;
-	int j;
 	
 	i = start;
 	while (args[i])
 	{
-		j = 0;
-		while (args[i][j])
-		{
-			write(1, &args[i][j], 1);
-			j++;
-		}
+		io_putstr(io, args[i]);
 		if (args[i + 1])
-			write(1, " ", 1);
+			io_write(io, " ", 1);
 		i++;
 	}
 	if (nl_flag)
-		write(1, "\n", 1);
+		io_write(io, "\n", 1);
 	return (0);
 }
@@ -17,11 +17,12 @@ Built-in command: env. Prints the environment variables.
 - Prints all environment variables to STDOUT.
 Returns 0 on success. Returns 1 on failure.
 */
-int	builtin_env(t_vars *vars)
+int	builtin_env(char **args, t_vars *vars, t_io *io)
 {
 	int	i;
 	int	cmdcode;
 
+	(void)args;
 	i = 0;
 	cmdcode = 0;
 	if (!vars || !vars->env)
@@ -31,7 +32,7 @@ int	builtin_env(t_vars *vars)
 	}
 	while (vars->env[i])
 	{
-		printf("%s\n", vars->env[i]);
+		io_putendl(io, vars->env[i]);
 		i++;
 	}
 	if (vars->pipeline != NULL)
@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/10 22:50:50 by lechan            #+#    #+#             */
-/*   Updated: 2025/03/21 04:17:29 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 21:02:14 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -15,28 +15,43 @@
 
 /*
 Built-in command: exit. Exits the shell.
-- Initializes cmdcode to 0 then updates it with the last command code.
-- Prints "exit" to STDOUT.
-- Saves history to HISTORY_FILE.
+- Initializes cmdcode to the last command code.
+- Prints "exit" to STDERR (interactive mode only), as bash does, so
+  "exit > file" leaves the notice out of the file.
+- Saves history to HISTORY_FILE (interactive mode only).
+- Neither happens in a forked pipeline stage or background job
+  ("echo | exit", "exit &"): only the process that loaded the history
+  is the interactive shell.
+- Prints parse cache hit rates if PCACHE_STATS_VAR is set.
 - Clears readline history.
 - Calls cleanup_exit() to free all allocated memory.
 - Exits the program with the last command code.
 Works with execute_builtin().
 */
-int	builtin_exit(t_vars *vars)
+int	builtin_exit(char **args, t_vars *vars, t_io *io)
 {
     int	cmdcode;
     
+    (void)args;
     cmdcode = 0;
+    if (vars)
+        cmdcode = vars->error_code;
     if (vars && vars->pipeline)
         cmdcode = vars->pipeline->last_cmdcode;
         
     fprintf(stderr, "DEBUG: [builtin_exit] Starting exit sequence with code %d\n", cmdcode);
-    ft_putendl_fd("exit", STDOUT_FILENO);
-    
-    // Critical operations only
-    save_history();
+    if (!vars || (vars->input.mode == INPUT_TTY
+            && vars->hist.owner == getpid()))
+    {
+        io_flush(io);
+        ft_putendl_fd("exit", STDERR_FILENO);
+        save_history();
+    }
+    if (vars)
+        pcache_report(vars);
     rl_clear_history();
+    if (vars)
+        free_input(&vars->input);
     
     // Null out problematic pointers without trying to free them
     fprintf(stderr, "DEBUG: [builtin_exit] Nulling problematic pointers\n");
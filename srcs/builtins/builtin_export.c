@@ -19,7 +19,7 @@ Example with arguments: export VAR_NAME="VALUE"
 Example without arguments: export
 Returns 0 on success, 1 on failure.
 */
-int builtin_export(char **args, t_vars *vars)
+int builtin_export(char **args, t_vars *vars, t_io *io)
 {
 	int cmdcode;
 	
@@ -31,8 +31,8 @@ int builtin_export(char **args, t_vars *vars)
 		return (cmdcode);
 	}
 	if (!args[1])
-		return (export_without_args(vars));
-	return (export_with_args(args, vars));
+		return (export_without_args(vars, io));
+	return (export_with_args(args, vars, io));
 }
 
 /*
@@ -40,7 +40,7 @@ Handle export WITH NO ARGUMENTS.
 - Prints all environment variables.
 Returns 0 on success, 1 on failure.
 */
-int	export_without_args(t_vars *vars)
+int	export_without_args(t_vars *vars, t_io *io)
 {
 	int	count;
 	int	cmdcode;
@@ -48,7 +48,7 @@ int	export_without_args(t_vars *vars)
 	count = 0;
 	while (vars->env[count])
 		count++;
-	cmdcode = sort_env(count, vars);
+	cmdcode = sort_env(count, vars, io);
 	if (vars->pipeline != NULL)
 		vars->pipeline->last_cmdcode = cmdcode;
 	return (cmdcode);
@@ -60,7 +60,7 @@ Handle export WITH ARGUMENTS.
 - Sets environment variables.
 Returns 0 on success, 1 on failure.
 */
-int	export_with_args(char **args, t_vars *vars)
+int	export_with_args(char **args, t_vars *vars, t_io *io)
 {
 	int i;
 	int cmdcode;
@@ -73,7 +73,9 @@ int	export_with_args(char **args, t_vars *vars)
 			modify_env(&vars->env, 1, args[i]);
 		else
 		{
-			printf("export: '%s': not a valid identifier\n", args[i]);
+			ft_putstr_fd("export: '", io->err);
+			ft_putstr_fd(args[i], io->err);
+			ft_putstr_fd("': not a valid identifier\n", io->err);
 			cmdcode = 1;
 		}
 		i++;
@@ -89,7 +91,7 @@ Master control function that sorts and prints environment variables.
 - Frees all allocated memory.
 Returns 0 on success, 1 on failure.
 */
-int sort_env(int count, t_vars *vars)
+int sort_env(int count, t_vars *vars, t_io *io)
 {
 	int		i;
 	int		cmdcode;
@@ -102,7 +104,7 @@ int sort_env(int count, t_vars *vars)
 	cmdcode = 0;
 	while (sort_env[i])
 	{
-		cmdcode = process_export_var(sort_env[i]);
+		cmdcode = process_export_var(sort_env[i], io);
 		i++;
 	}
 	i = 0;
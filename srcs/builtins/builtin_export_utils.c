@@ -109,7 +109,7 @@ Master control function to process and print a single environment variable.
 - If it doesn't have a value, prints the variable only.
 Returns 0 on success.
 */
-int	process_export_var(char *env_var)
+int	process_export_var(char *env_var, t_io *io)
 {
     char	*equal_pos;
     
@@ -117,12 +117,13 @@ int	process_export_var(char *env_var)
     if (equal_pos)
     {
         *equal_pos = '\0';
-        process_var_with_val(env_var, equal_pos + 1);
+        process_var_with_val(env_var, equal_pos + 1, io);
         *equal_pos = '=';
     }
     else
     {
-        printf("declare -x %s\n", env_var);
+        io_putstr(io, "declare -x ");
+        io_putendl(io, env_var);
     }
     return (0);
 }
@@ -133,17 +134,19 @@ Process and print a variable with a value (has equals sign).
 Example: "declare -x VAR_NAME="VALUE"
 Returns 0 on success.
 */
-int process_var_with_val(char *name, char *value)
+int process_var_with_val(char *name, char *value, t_io *io)
 {
-	printf("declare -x %s=\"", name);
+	io_putstr(io, "declare -x ");
+	io_putstr(io, name);
+	io_write(io, "=\"", 2);
 	while (*value)
 	{
 		if (*value == '"')
-			printf("\\\"");
+			io_write(io, "\\\"", 2);
 		else
-			printf("%c", *value);
+			io_write(io, value, 1);
 		value++;
 	}
-	printf("\"\n");
+	io_write(io, "\"\n", 2);
 	return (0);
 }
@@ -0,0 +1,85 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   builtin_fg.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/24 12:20:51 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:48:12 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Built-in command: fg. Brings a job to the foreground.
+- Hands the job's process group the terminal and continues it
+  (a job may have stopped itself reading the terminal).
+- Waits for it to exit or stop again, then takes the terminal back.
+- A job that stops again stays in the table as Stopped.
+Returns:
+The job's exit code, 1 if there is no such job.
+
+Example: "sleep 30 &" then "fg"
+- Prints "sleep 30" and waits for it
+*/
+int	builtin_fg(char **args, t_vars *vars, t_io *io)
+{
+	t_job	*job;
+	int		ret;
+
+	job = find_job(vars, args[1]);
+	if (!job)
+		return (copy_error("fg", args[1] ? args[1] : "current",
+				"no such job", io));
+	io_putendl(io, job->cmd);
+	io_flush(io);
+	vars->job_current = job->id - 1;
+	if (vars->job_control)
+		tcsetpgrp(STDIN_FILENO, job->pid);
+	signal_job(vars, job, SIGCONT);
+	job->state = JOB_RUNNING;
+	ret = wait_job(vars, job, WUNTRACED);
+	reclaim_terminal(vars, ret);
+	if (job->state == JOB_STOPPED)
+	{
+		io_write(io, "\n", 1);
+		print_job(vars, job, io);
+	}
+	else if (job->state == JOB_DONE)
+		remove_job(vars, job);
+	return (ret);
+}
+
+/*
+Built-in command: bg. Resumes a stopped job in the background.
+- SIGCONT goes to the job's whole process group.
+Returns:
+0 on success, 1 if there is no such job.
+
+Example: Job 1 was stopped with Ctrl+Z
+- Sends SIGCONT and prints "[1]+ vim notes.txt &"
+*/
+int	builtin_bg(char **args, t_vars *vars, t_io *io)
+{
+	t_job	*job;
+	char	*num;
+
+	job = find_job(vars, args[1]);
+	if (!job)
+		return (copy_error("bg", args[1] ? args[1] : "current",
+				"no such job", io));
+	signal_job(vars, job, SIGCONT);
+	if (job->state != JOB_DONE)
+		job->state = JOB_RUNNING;
+	vars->job_current = job->id - 1;
+	num = ft_itoa(job->id);
+	io_write(io, "[", 1);
+	io_putstr(io, num);
+	io_write(io, "]+ ", 3);
+	io_putstr(io, job->cmd);
+	io_putendl(io, " &");
+	ft_safefree((void **)&num);
+	return (0);
+}
@@ -0,0 +1,43 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   builtin_jobs.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/24 11:30:44 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:48:12 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Built-in command: jobs. Lists background jobs.
+- Reaps finished jobs first, so the states are current.
+- Finished jobs are shown once as Done/Exit and then dropped.
+Returns 0.
+
+Example: After "sleep 50 &" and "false &"
+- [1]   Running                 sleep 50
+- [2]+  Exit                    false
+*/
+int	builtin_jobs(char **args, t_vars *vars, t_io *io)
+{
+	int	i;
+
+	(void)args;
+	poll_jobs(vars, 0);
+	i = 0;
+	while (i < JOBS_MAX)
+	{
+		if (vars->jobs[i].pid != 0)
+		{
+			print_job(vars, &vars->jobs[i], io);
+			if (vars->jobs[i].state == JOB_DONE)
+				remove_job(vars, &vars->jobs[i]);
+		}
+		i++;
+	}
+	return (0);
+}
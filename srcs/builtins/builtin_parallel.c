@@ -0,0 +1,233 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   builtin_parallel.c                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/24 14:48:12 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:27:45 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Parses the options and template of a parallel command line.
+- "-j N" or "-jN" sets the number of job slots (default: online CPUs).
+- The template runs from the first non-option word up to ":::".
+- Words after ":::" are the items; without ":::" items come from stdin.
+Returns:
+0 on success, 1 on a usage error (message already printed).
+Works with builtin_parallel().
+
+Example: {"parallel", "-j", "4", "gzip", "{}", ":::", "a", "b"}
+- par->jobs = 4, par->tmpl = {"gzip", "{}"}, par->items = {"a", "b"}
+*/
+int	par_parse(char **args, t_parallel *par, t_io *io)
+{
+	char	*num;
+	int		i;
+
+	i = 1;
+	par->jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	while (args[i] && ft_strncmp(args[i], "-j", 2) == 0)
+	{
+		num = args[i] + 2;
+		if (!*num)
+			num = args[++i];
+		if (!num || ft_atoi(num) <= 0)
+			return (copy_error("parallel", "-j", "invalid job count", io));
+		par->jobs = ft_atoi(num);
+		i++;
+	}
+	if (par->jobs < 1)
+		par->jobs = 1;
+	if (par->jobs > PAR_JOBS_MAX)
+		par->jobs = PAR_JOBS_MAX;
+	par->tmpl = &args[i];
+	while (args[i] && ft_strcmp(args[i], PAR_ITEM_SEP) != 0)
+		i++;
+	if (args[i])
+	{
+		par->sep = i;
+		par->sep_word = args[i];
+		args[i] = NULL;
+		par->items = &args[i + 1];
+	}
+	if (!par->tmpl[0])
+		return (copy_error("parallel", "usage",
+				"parallel [-j N] command [args] [::: items]", io));
+	return (0);
+}
+
+/*
+Reads all of a builtin's input into memory.
+- The buffer starts at PAR_BUF_SZ and doubles whenever it fills up,
+  so large inputs are copied only a logarithmic number of times.
+- The data is NUL-terminated, len holds the byte count.
+- A read interrupted by Ctrl+C (EINTR) stops the builtin: nothing
+  read so far is used.
+Returns:
+Newly allocated data, or NULL on failure. errno is EINTR if the read
+was interrupted.
+Works with par_read_items() and builtin_xargs().
+*/
+char	*par_read_all(int fd, size_t *len)
+{
+	char	*data;
+	char	*grown;
+	size_t	cap;
+	ssize_t	ret;
+
+	*len = 0;
+	cap = PAR_BUF_SZ;
+	data = malloc(cap + 1);
+	ret = 1;
+	while (data && ret != 0)
+	{
+		if (*len == cap)
+		{
+			grown = malloc(cap * 2 + 1);
+			if (grown)
+				ft_memcpy(grown, data, *len);
+			free(data);
+			data = grown;
+			cap *= 2;
+			continue ;
+		}
+		ret = read(fd, data + *len, cap - *len);
+		if (ret == -1)
+			break ;
+		*len += ret;
+	}
+	if (data && ret == -1 && errno == EINTR)
+	{
+		free(data);
+		errno = EINTR;
+		return (NULL);
+	}
+	if (data)
+		data[*len] = '\0';
+	return (data);
+}
+
+/*
+Reads parallel items from the builtin's input, one per line.
+- Empty lines are skipped.
+Returns:
+Newly allocated item array, or NULL on failure.
+Works with builtin_parallel().
+*/
+char	**par_read_items(int fd)
+{
+	char	*data;
+	char	**items;
+	size_t	len;
+
+	data = par_read_all(fd, &len);
+	if (!data)
+		return (NULL);
+	items = ft_split(data, '\n');
+	free(data);
+	return (items);
+}
+
+/*
+Resolves the template command once for the whole run.
+- Builtins are looked up in the dispatch table.
+- External commands are searched in PATH a single time, not per job.
+Returns:
+0 on success, 127 if the command cannot be found.
+Works with builtin_parallel().
+*/
+int	par_resolve(t_parallel *par, t_vars *vars, t_io *io)
+{
+	par->builtin = get_builtin(par->tmpl[0]);
+	if (par->builtin)
+		return (0);
+	par->path = get_cmd_path(par->tmpl[0], vars->env, vars);
+	if (!par->path)
+		return (copy_error("parallel", par->tmpl[0], "command not found",
+				io) + 126);
+	return (0);
+}
+
+/*
+Releases everything a parallel run allocated.
+- Waits for any job still running (after an error or Ctrl+C).
+- Puts back the ":::" separator cut out of args by par_parse().
+Works with builtin_parallel().
+*/
+void	par_cleanup(t_parallel *par, char **args, char **read_items, t_io *io)
+{
+	while (par->running > 0)
+	{
+		if (par_drain(par, io) != 0)
+			break ;
+	}
+	par->jobs = PAR_JOBS_MAX;
+	while (par->jobs-- > 0)
+		ft_safefree((void **)&par->slots[par->jobs].buf);
+	ft_safefree((void **)&par->path);
+	if (read_items)
+		ft_free_2d(read_items, ft_arrlen(read_items));
+	if (par->sep)
+		args[par->sep] = par->sep_word;
+}
+
+/*
+Built-in command: parallel. Runs a command once per item, N at a time.
+- Items come from the words after ":::" or from stdin, one per line.
+- "{}" in the template is replaced by the item, otherwise the item is
+  appended as the last argument.
+- Up to N jobs run at once. Each job costs a single fork (plus exec
+  for external commands); no helper shell is started.
+- Each job's stdout is buffered and written out whole when it ends,
+  so output of different jobs never interleaves.
+Returns:
+0 if every job succeeded, otherwise the number of failed jobs
+(at most 101, like GNU parallel). 127 if the command is not found,
+130 if reading the items was interrupted.
+
+Example: "parallel -j 2 gzip -k {} ::: a.log b.log c.log"
+- Compresses a.log and b.log at once, then c.log when a slot frees
+*/
+int	builtin_parallel(char **args, t_vars *vars, t_io *io)
+{
+	t_parallel	par;
+	char		**read_items;
+	int			i;
+	int			ret;
+
+	ft_memset(&par, 0, sizeof(t_parallel));
+	read_items = NULL;
+	ret = par_parse(args, &par, io);
+	if (ret == 0)
+		ret = par_resolve(&par, vars, io);
+	if (ret == 0 && !par.items)
+	{
+		errno = 0;
+		par.items = read_items = par_read_items(io->in);
+		if (!par.items && errno == EINTR)
+			ret = 130;
+	}
+	i = 0;
+	io_flush(io);
+	while (ret == 0 && par.items && par.items[i])
+	{
+		while (ret == 0 && par.running == par.jobs)
+			ret = par_drain(&par, io);
+		if (ret == 0 && par_spawn(&par, &par.slots[par_free_slot(&par)],
+				par.items[i++], vars) == -1)
+			ret = copy_error("parallel", par.tmpl[0], strerror(errno), io);
+	}
+	while (ret == 0 && par.running > 0)
+		ret = par_drain(&par, io);
+	par_cleanup(&par, args, read_items, io);
+	if (ret != 0)
+		return (ret);
+	if (par.failed > PAR_FAILED_MAX)
+		return (PAR_FAILED_MAX);
+	return (par.failed);
+}
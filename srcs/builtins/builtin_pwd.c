@@ -20,11 +20,12 @@ Built-in command: pwd. Prints the current working directory.
 - Frees the current working directory string.
 Returns 0 on success, 1 on failure.
 */
-int	builtin_pwd(t_vars *vars)
+int	builtin_pwd(char **args, t_vars *vars, t_io *io)
 {
     char	*cwd;
     int		cmdcode;
 
+    (void)args;
     cmdcode = 0;
     if (!vars || !vars->env)
     {
@@ -42,7 +43,7 @@ int	builtin_pwd(t_vars *vars)
             vars->pipeline->last_cmdcode = cmdcode;
         return (cmdcode);
     }
-    printf("%s\n", cwd);
+    io_putendl(io, cwd);
     ft_safefree((void **)&cwd);
     if (vars->pipeline != NULL)
         vars->pipeline->last_cmdcode = cmdcode;
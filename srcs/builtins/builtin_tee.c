@@ -0,0 +1,197 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   builtin_tee.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/23 11:42:30 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:55:37 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Opens the files named on the tee command line.
+- Skips the -a option, which selects append mode.
+- Files that cannot be opened are reported and left out.
+- fds must have room for every argument.
+Returns:
+Number of files opened into fds.
+Works with builtin_tee().
+*/
+int	open_tee_files(char **args, int append, int *fds, t_io *io)
+{
+	int	count;
+	int	flags;
+	int	i;
+
+	flags = set_redirect_flags(1 + append) | O_CLOEXEC;
+	count = 0;
+	i = 1 + append;
+	while (args[i])
+	{
+		fds[count] = open(args[i], flags, 0644);
+		if (fds[count] == -1)
+			copy_error("tee", args[i], strerror(errno), io);
+		else
+			count++;
+		i++;
+	}
+	return (count);
+}
+
+/*
+Moves exactly len bytes from a pipe into a file with splice().
+Returns:
+0 on success, -1 on error.
+Works with tee_zero_copy().
+*/
+int	splice_all(int in, int out, ssize_t len)
+{
+	ssize_t	n;
+
+	while (len > 0)
+	{
+		n = splice(in, NULL, out, NULL, len, SPLICE_F_MOVE);
+		if (n <= 0)
+			return (-1);
+		len -= n;
+	}
+	return (0);
+}
+
+/*
+Duplicates a pipe into another pipe and one file without copying.
+- tee() clones the pipe contents into the output pipe.
+- splice() then drains the same bytes from the input into the file.
+Returns:
+- 1 when the input reached end of file.
+- 0 if tee() is not supported for these fds (nothing copied).
+- -1 on error, with errno set.
+Works with builtin_tee().
+*/
+int	tee_zero_copy(int in, int out, int file)
+{
+	ssize_t	n;
+	int		copied;
+
+	copied = 0;
+	while (1)
+	{
+		n = tee(in, out, COPY_CHUNK, 0);
+		if (n == 0)
+			return (1);
+		if (n < 0 && copy_unsupported(copied))
+			return (0);
+		if (n < 0 || splice_all(in, file, n) == -1)
+			return (-1);
+		copied = 1;
+	}
+}
+
+/*
+Copies input to output and every file through one large buffer.
+- A file that fails to write is closed and skipped from then on.
+Returns:
+- 1 when the input reached end of file.
+- -1 on read error, with errno set.
+Works with builtin_tee().
+*/
+int	tee_rw(t_io *io, int *fds, int count)
+{
+	char	buf[COPY_BUF_SZ];
+	ssize_t	n;
+	int		i;
+
+	while (1)
+	{
+		n = read(io->in, buf, COPY_BUF_SZ);
+		if (n == 0)
+			return (1);
+		if (n < 0)
+			return (-1);
+		io_write_direct(io, buf, n);
+		i = 0;
+		while (i < count)
+		{
+			if (fds[i] != -1 && write(fds[i], buf, n) != n)
+			{
+				close(fds[i]);
+				fds[i] = -1;
+			}
+			i++;
+		}
+	}
+}
+
+/*
+Picks the copy method for tee and runs it.
+- Pipe in, pipe out and one file: tee() + splice(), no user copy.
+- No files: plain copy_fd() from input to output.
+- Otherwise a buffered read/write loop.
+Returns:
+1 when the input reached end of file, -1 on error with errno set.
+Works with builtin_tee().
+*/
+int	tee_copy(t_io *io, int *fds, int count)
+{
+	int	ret;
+
+	ret = 0;
+	if (count == 0 && copy_fd(io->in, io->out) == -1)
+		ret = -1;
+	else if (count == 0)
+		ret = 1;
+	else if (count == 1)
+		ret = tee_zero_copy(io->in, io->out, fds[0]);
+	if (ret == 0)
+		ret = tee_rw(io, fds, count);
+	return (ret);
+}
+
+/*
+Built-in command: tee. Copies standard input to output and files.
+- -a appends to the files instead of truncating them. Any other
+  option sends the call to the system tee.
+- Any number of files: the descriptor array is sized to the arguments.
+- The copy itself is done by tee_copy().
+Returns:
+0 on success, 1 if any file could not be opened or copying failed,
+130 if Ctrl+C interrupted the copy.
+
+Example: "make 2>&1 | tee build.log | grep error"
+- in and out are pipes, one file
+- Each chunk is cloned into the grep pipe and spliced into build.log
+*/
+int	builtin_tee(char **args, t_vars *vars, t_io *io)
+{
+	int	*fds;
+	int	count;
+	int	append;
+	int	ret;
+	int	i;
+
+	io_flush(io);
+	if (!copy_supported(args, "-a"))
+		return (copy_external(args, vars, io));
+	append = (args[1] && ft_strcmp(args[1], "-a") == 0);
+	fds = malloc(sizeof(int) * ft_arrlen(args));
+	if (!fds)
+		return (copy_error("tee", "open", strerror(ENOMEM), io));
+	count = open_tee_files(args, append, fds, io);
+	ret = tee_copy(io, fds, count);
+	if (ret == -1 && errno == EINTR)
+		ret = 128 + SIGINT;
+	else if (ret == -1)
+		ret = copy_error("tee", "read", strerror(errno), io);
+	else
+		ret = (count != (int)ft_arrlen(args) - 1 - append);
+	i = 0;
+	while (i < count)
+		if (fds[i++] != -1)
+			close(fds[i - 1]);
+	free(fds);
+	return (ret);
+}
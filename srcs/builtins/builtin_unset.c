@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/10 22:51:06 by lechan            #+#    #+#             */
-/*   Updated: 2025/03/20 05:32:29 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 17:21:03 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -32,11 +32,12 @@ int	builtin_unset(char **args, t_vars *vars)
 	return (0);
 }
 */
-int	builtin_unset(char **args, t_vars *vars)
+int	builtin_unset(char **args, t_vars *vars, t_io *io)
 {
     int	i;
     int cmdcode;
 
+    (void)io;
     cmdcode = 0;
     if ((!vars || !vars->env) && (vars && vars->pipeline != NULL))
     {
@@ -124,12 +125,9 @@ int set_next_pos(int changes, char **env, char **new_env, int pos)
 */
 int	set_next_pos(int changes, char **env, int pos)
 {
-    void *ptr;
-    
     if (changes == -1)
     {
-        ptr = (void *)env[pos];
-        ft_safefree(&ptr);
+        free_env_entry(env[pos]);
         return (pos + 1);
     }
     else if (changes == 1)
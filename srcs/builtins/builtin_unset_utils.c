@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/18 12:12:38 by lechan            #+#    #+#             */
-/*   Updated: 2025/03/18 15:16:01 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 17:21:03 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -30,6 +30,9 @@ void copy_env_front(char **src, char **dst, int pos)
 
 /*
 Copy remaining environment entries with offset.
+- After an addition idx is the first destination slot past the new
+  variable, after a removal it is the first source entry past the
+  removed one (see set_next_pos()).
 Works with realloc_until_var.
 */
 void copy_env_back(char **src, char **dst, int idx, int offset)
@@ -39,6 +42,11 @@ void copy_env_back(char **src, char **dst, int idx, int offset)
 
     i = idx;
     j = idx - offset;
+    if (offset < 0)
+    {
+        i = idx + offset;
+        j = idx;
+    }
     while (src[j])
     {
         dst[i] = src[j];
@@ -0,0 +1,121 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   builtin_wait.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/24 11:52:19 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:48:12 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Blocks until a job exits (or stops, with WUNTRACED in options).
+- Sleeps on the signalfd and rechecks the job on every SIGCHLD.
+- Ctrl+C interrupts the wait and leaves the job in the table.
+- Without a signalfd, falls back to a blocking waitpid().
+Returns:
+The job's exit code, or 130 if the wait was interrupted.
+Works with builtin_wait() and builtin_fg().
+*/
+int	wait_job(t_vars *vars, t_job *job, int options)
+{
+	int	ret;
+
+	if (job->state == JOB_DONE)
+		return (job->status);
+	if (vars->events.sigfd < 0)
+		options &= ~WNOHANG;
+	else
+		options |= WNOHANG;
+	while (1)
+	{
+		ret = reap_job(vars, job, options);
+		if (ret > 0)
+			return (job->status);
+		if (ret == -1 && errno != EINTR)
+			return (130);
+		if (ret == 0 && (wait_signal(vars) & (1 << SIGINT)))
+			return (130);
+	}
+}
+
+/*
+Waits for whichever running job finishes first (wait -n).
+Returns:
+Exit code of that job, 127 if there are no running jobs,
+130 if interrupted.
+Works with builtin_wait().
+*/
+int	wait_next_job(t_vars *vars)
+{
+	int	ret;
+	int	i;
+
+	while (1)
+	{
+		i = 0;
+		while (i < JOBS_MAX && (vars->jobs[i].pid == 0
+				|| vars->jobs[i].state != JOB_DONE))
+			i++;
+		if (i < JOBS_MAX)
+		{
+			ret = vars->jobs[i].status;
+			remove_job(vars, &vars->jobs[i]);
+			return (ret);
+		}
+		ret = poll_jobs(vars, -1);
+		if (ret == -1)
+			return (130);
+		i = 0;
+		while (i < JOBS_MAX && (vars->jobs[i].pid == 0
+				|| vars->jobs[i].state != JOB_RUNNING))
+			i++;
+		if (ret == 0 && i == JOBS_MAX)
+			return (127);
+	}
+}
+
+/*
+Built-in command: wait. Waits for background jobs.
+- No operand: waits for every running job, returns 0.
+- -n: waits for the next job to finish, returns its status.
+- %N or PID: waits for that job, returns its status.
+Returns 127 if the job does not exist.
+
+Example: "sleep 1 & sleep 2 &" then "wait -n"
+- Returns after about 1 second with the status of "sleep 1"
+*/
+int	builtin_wait(char **args, t_vars *vars, t_io *io)
+{
+	t_job	*job;
+	int		ret;
+	int		i;
+
+	if (args[1] && ft_strcmp(args[1], "-n") == 0)
+		return (wait_next_job(vars));
+	if (args[1])
+	{
+		job = find_job(vars, args[1]);
+		if (!job)
+			return (copy_error("wait", args[1], "no such job", io) + 126);
+		ret = wait_job(vars, job, 0);
+		if (job->state == JOB_DONE)
+			remove_job(vars, job);
+		return (ret);
+	}
+	i = 0;
+	while (i < JOBS_MAX)
+	{
+		if (vars->jobs[i].pid != 0 && wait_job(vars, &vars->jobs[i], 0) == 130
+			&& vars->jobs[i].state != JOB_DONE)
+			return (130);
+		if (vars->jobs[i].state == JOB_DONE)
+			remove_job(vars, &vars->jobs[i]);
+		i++;
+	}
+	return (0);
+}
@@ -0,0 +1,262 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   builtin_xargs.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/24 16:21:09 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:27:45 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Parses the options of an xargs command line.
+- "-P N": run up to N batches at once (0 means online CPUs).
+- "-n N": put at most N items in one batch.
+- "-0": items from stdin are separated by NUL instead of whitespace.
+- The command template runs up to ":::" if given; the words after it
+  are the items instead of stdin.
+Returns:
+0 on success, 1 on a usage error (message already printed).
+Works with builtin_xargs().
+*/
+int	xargs_parse(char **args, t_xargs *xa, t_io *io)
+{
+	int	i;
+
+	i = 1;
+	xa->par.jobs = 1;
+	while (args[i] && args[i][0] == '-' && args[i][1])
+	{
+		if (ft_strcmp(args[i], "-0") == 0)
+			xa->nul = 1;
+		else if (ft_strcmp(args[i], "-P") == 0 && args[i + 1])
+			xa->par.jobs = ft_atoi(args[++i]);
+		else if (ft_strcmp(args[i], "-n") == 0 && args[i + 1]
+			&& ft_atoi(args[i + 1]) > 0)
+			xa->max_args = ft_atoi(args[++i]);
+		else
+			return (copy_error("xargs", args[i], "invalid option", io));
+		i++;
+	}
+	if (xa->par.jobs <= 0)
+		xa->par.jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (xa->par.jobs < 1 || xa->par.jobs > PAR_JOBS_MAX)
+		xa->par.jobs = PAR_JOBS_MAX;
+	xa->par.tmpl = &args[i];
+	while (args[i] && ft_strcmp(args[i], PAR_ITEM_SEP) != 0)
+		i++;
+	if (args[i])
+	{
+		xa->par.sep = i;
+		xa->par.sep_word = args[i];
+		args[i] = NULL;
+		xa->par.items = &args[i + 1];
+	}
+	if (!xa->par.tmpl[0])
+		return (copy_error("xargs", "usage",
+				"xargs [-0] [-n N] [-P N] command [args] [::: items]", io));
+	return (0);
+}
+
+/*
+Splits xargs input into items.
+- Default: items are separated by spaces, tabs and newlines.
+- nul: items are separated by NUL bytes, so names may hold blanks.
+- The input is cut in place; items point into data.
+Returns:
+Newly allocated array of pointers into data, or NULL on failure.
+Works with builtin_xargs().
+
+Example: "a.c b.c\nc.c\n"
+- Returns {"a.c", "b.c", "c.c", NULL}
+*/
+char	**xargs_split(char *data, size_t len, int nul)
+{
+	char	**items;
+	size_t	count;
+	size_t	i;
+
+	count = 0;
+	i = 0;
+	while (i < len)
+	{
+		if (data[i] == '\0' || (!nul && ft_strchr(" \t\n", data[i])))
+			data[i] = '\0';
+		else if (i == 0 || data[i - 1] == '\0')
+			count++;
+		i++;
+	}
+	items = malloc(sizeof(char *) * (count + 1));
+	if (!items)
+		return (NULL);
+	count = 0;
+	i = 0;
+	while (i < len)
+	{
+		if (data[i] && (i == 0 || data[i - 1] == '\0'))
+			items[count++] = data + i;
+		i++;
+	}
+	items[count] = NULL;
+	return (items);
+}
+
+/*
+Works out how many argument bytes are left for items in one execve().
+- Starts from the kernel's ARG_MAX (sysconf(_SC_ARG_MAX)).
+- Every string costs its length + 1 plus one pointer in argv/envp.
+- Subtracts the environment, the command template and a safety
+  margin of XARGS_HEADROOM bytes.
+Returns:
+Byte budget for items, 0 if even the template does not fit.
+Works with builtin_xargs().
+*/
+size_t	xargs_budget(char **tmpl, char **env)
+{
+	long	limit;
+	size_t	used;
+	int		i;
+
+	limit = sysconf(_SC_ARG_MAX);
+	if (limit <= 0)
+		limit = XARGS_ARG_STRLEN;
+	used = XARGS_HEADROOM + sizeof(char *) * 2;
+	i = -1;
+	while (env && env[++i])
+		used += ft_strlen(env[i]) + 1 + sizeof(char *);
+	i = -1;
+	while (tmpl[++i])
+		used += ft_strlen(tmpl[i]) + 1 + sizeof(char *);
+	if (used >= (size_t)limit)
+		return (0);
+	return ((size_t)limit - used);
+}
+
+/*
+Fills argv with the template followed by as many items as fit.
+- Takes items from xa->next while their total cost stays within
+  xa->budget and the count stays within -n.
+Returns:
+Number of items put in the batch, 0 if the next item alone is too
+long to ever be passed to a command.
+Works with builtin_xargs().
+
+Example: Template {"rm"}, budget allows 2 items of {"a", "b", "c"}
+- argv = {"rm", "a", "b", NULL}, returns 2, next item is "c"
+*/
+size_t	xargs_batch(t_xargs *xa, char **argv)
+{
+	size_t	cost;
+	size_t	used;
+	size_t	n;
+	int		i;
+
+	i = -1;
+	while (xa->par.tmpl[++i])
+		argv[i] = xa->par.tmpl[i];
+	used = 0;
+	n = 0;
+	while (xa->par.items[xa->next + n]
+		&& (xa->max_args == 0 || n < (size_t)xa->max_args))
+	{
+		cost = ft_strlen(xa->par.items[xa->next + n]);
+		if (cost >= XARGS_ARG_STRLEN)
+			break ;
+		cost += 1 + sizeof(char *);
+		if (used + cost > xa->budget)
+			break ;
+		used += cost;
+		argv[i + n] = xa->par.items[xa->next + n];
+		n++;
+	}
+	argv[i + n] = NULL;
+	xa->next += n;
+	return (n);
+}
+
+/*
+Built-in command: xargs. Runs a command on items in maximal batches.
+- Items come from stdin or from the words after ":::".
+- Each batch holds as many items as fit under the kernel's argument
+  limit, after the environment and template, so a million file names
+  take the fewest possible execs instead of failing with E2BIG.
+- With -P N, up to N batches run at once. Output of each batch is
+  buffered and written whole, so batches never interleave.
+- Nothing is run when there are no items.
+Returns:
+0 if every batch succeeded, 123 if any failed, 127 if the command
+is not found, 1 on usage errors or an item too long to pass, 130 if
+reading the items was interrupted.
+
+Example: "find . -name '*.o' | xargs -P 4 rm -f"
+- Splits the names into ARG_MAX-sized batches, four rm at a time
+*/
+int	builtin_xargs(char **args, t_vars *vars, t_io *io)
+{
+	t_xargs	xa;
+	char	**argv;
+	int		ret;
+
+	ft_memset(&xa, 0, sizeof(t_xargs));
+	ret = xargs_parse(args, &xa, io);
+	if (ret == 0)
+		ret = par_resolve(&xa.par, vars, io);
+	if (ret == 0 && !xa.par.items)
+	{
+		errno = 0;
+		xa.data = par_read_all(io->in, &xa.len);
+		if (!xa.data && errno == EINTR)
+			ret = 130;
+		if (xa.data)
+			xa.par.items = xa.split = xargs_split(xa.data, xa.len, xa.nul);
+	}
+	argv = NULL;
+	if (ret == 0 && xa.par.items)
+	{
+		xa.budget = xargs_budget(xa.par.tmpl, vars->env);
+		argv = malloc(sizeof(char *) * (ft_arrlen(xa.par.tmpl)
+					+ ft_arrlen(xa.par.items) + 1));
+	}
+	io_flush(io);
+	if (argv)
+		ret = xargs_run(&xa, argv, vars, io);
+	free(argv);
+	par_cleanup(&xa.par, args, NULL, io);
+	free(xa.split);
+	free(xa.data);
+	if (ret == 0 && xa.par.failed > 0)
+		return (XARGS_FAILED);
+	return (ret);
+}
+
+/*
+Launches batches until all items are used.
+- Waits for a free slot whenever -P slots are busy.
+Returns:
+0 on success, 1 if an item is too long or a job could not start.
+Works with builtin_xargs().
+*/
+int	xargs_run(t_xargs *xa, char **argv, t_vars *vars, t_io *io)
+{
+	int	ret;
+
+	ret = 0;
+	while (ret == 0 && xa->par.items[xa->next])
+	{
+		if (xargs_batch(xa, argv) == 0)
+			return (copy_error("xargs", xa->par.items[xa->next],
+					"argument too long", io));
+		while (ret == 0 && xa->par.running == xa->par.jobs)
+			ret = par_drain(&xa->par, io);
+		if (ret == 0 && par_launch(&xa->par,
+				&xa->par.slots[par_free_slot(&xa->par)], argv, vars) == -1)
+			ret = copy_error("xargs", argv[0], strerror(errno), io);
+	}
+	while (ret == 0 && xa->par.running > 0)
+		ret = par_drain(&xa->par, io);
+	return (ret);
+}
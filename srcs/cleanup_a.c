@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/16 01:03:56 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/20 19:54:27 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 17:21:03 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -17,7 +17,7 @@ Frees a partially allocated environment array up to index n-1.
 - Takes the environment array and number of elements to free.
 - Safely frees each string element, then frees the array itself.
 - Prevents memory leaks during initialization errors.
-Works with ft_free_2d() and dup_env().
+Works with make_sorted_env().
 */
 void	cleanup_env_error(char **env, int n)
 {
@@ -252,7 +252,7 @@ void	cleanup_vars(t_vars *vars)
     {
         env_count = ft_arrlen(vars->env);
         fprintf(stderr, "DEBUG: [cleanup_vars] Freeing %d environment variables\n", env_count);
-        ft_free_2d(vars->env, env_count);
+        free_env(vars->env);
         vars->env = NULL;
     }
     
@@ -279,7 +279,7 @@ void	cleanup_vars(t_vars *vars)
     vars->astroot = NULL;
     vars->head = NULL;
     vars->current = NULL;
-    vars->quote_depth = 0;
+    free_vectors(vars);
     
     // CRITICAL FIX: Only access pipeline if it exists
     // This prevents trying to access a pipeline that might have been freed
@@ -317,6 +317,7 @@ void	cleanup_exit(t_vars *vars)
 /*
 Performs complete cleanup before exiting on Ctrl+D.
 - Cleans token list to prevent double-free errors.
+- Prints parse cache hit rates if PCACHE_STATS_VAR is set.
 - Saves command history to file.
 - Frees all allocated resources.
 - Clears readline history.
@@ -333,6 +334,7 @@ void	cleanup_exit(t_vars *vars)
     if (!vars)
         return ;
     fprintf(stderr, "DEBUG: Starting cleanup before exit\n");
+    pcache_report(vars);
     save_history();
 	cleanup_token_list(vars);
     cleanup_vars(vars);
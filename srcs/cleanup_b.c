@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/16 01:03:50 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 11:45:07 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 19:41:03 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -55,6 +55,7 @@ void	cleanup_ast(t_node *node)
         fprintf(stderr, "DEBUG: [cleanup_ast] Freeing args for node at depth %d\n", my_depth);
         ft_free_2d(node->args, ft_arrlen(node->args));
     }
+    ft_safefree((void **)&node->words);
     
     ft_safefree((void **)&node);
     fprintf(stderr, "DEBUG: [cleanup_ast] Node at depth %d freed\n", my_depth);
@@ -64,6 +65,7 @@ void	cleanup_ast(t_node *node)
 /*
 Free a single token node and its arguments.
 - Takes a node pointer and frees its arguments array.
+- Frees the word templates built from those arguments.
 - Then frees the node itself.
 - Used for individual node cleanup without recursion.
 Works with cleanup_token_list().
@@ -91,32 +93,24 @@ void	free_token_node(t_node *node)
 {
     int	i;
     
-	fprintf(stderr, "DEBUG: [free_token_node] Starting to free node %p of type %d\n", 
-		(void*)node, node->type);
     if (!node)
     {
-        fprintf(stderr, "DEBUG: [free_token_node] Node is NULL\n");
         return;
     }
     
-    fprintf(stderr, "DEBUG: [free_token_node] Freeing node type %d\n", node->type);
-    
     if (node->args)
     {
         i = 0;
         while (node->args[i])
         {
-            fprintf(stderr, "DEBUG: [free_token_node] Freeing arg[%d]: '%s'\n", 
-                    i, node->args[i]);
             ft_safefree((void **)&node->args[i]);
             i++;
         }
         ft_safefree((void **)&node->args);
-        fprintf(stderr, "DEBUG: [free_token_node] Freed %d args\n", i);
     }
+    ft_safefree((void **)&node->words);
     
     ft_safefree((void **)&node);
-    fprintf(stderr, "DEBUG: [free_token_node] Node freed\n");
 }
 
 /*
@@ -178,36 +172,22 @@ void cleanup_token_list(t_vars *vars)
 {
     t_node *current;
     t_node *next;
-    int count;
 
-    fprintf(stderr, "DEBUG: [cleanup_token_list] Starting token list cleanup\n");
-    
     if (!vars || !vars->head)
     {
-        fprintf(stderr, "DEBUG: [cleanup_token_list] Nothing to clean up (head=%p)\n", 
-                vars ? (void*)vars->head : NULL);
         return;
     }
 
-    fprintf(stderr, "DEBUG: [cleanup_token_list] Starting cleanup with head=%p\n",
-            (void*)vars->head);
-
     current = vars->head;
-    count = 0;
     while (current)
     {
         next = current->next;
-        fprintf(stderr, "DEBUG: [cleanup_token_list] Freeing token %d\n", count);
         free_token_node(current);
         current = next;
-        count++;
     }
 
     vars->head = NULL;
     vars->current = NULL;
-    fprintf(stderr, "DEBUG: [cleanup_token_list] %d tokens cleaned up\n", count);
-    fprintf(stderr, "DEBUG: [cleanup_token_list] Completed cleanup, head now=%p\n", 
-            (void*)vars->head);
 }
 
 /*
@@ -0,0 +1,366 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cmd_table.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/26 16:05:48 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:36:18 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Finds the value of PATH in an environment without copying it.
+Returns:
+Pointer to the text after "PATH=", or NULL if PATH is not set.
+Works with cmdtab_find().
+*/
+char	*env_path(char **envp)
+{
+	int	i;
+
+	i = 0;
+	while (envp && envp[i] && ft_strncmp(envp[i], "PATH=", 5) != 0)
+		i++;
+	if (!envp || !envp[i])
+		return (NULL);
+	return (envp[i] + 5);
+}
+
+/*
+Empties the command table and drops its inotify watches.
+- The descriptor leaves the epoll set before it is closed, since a
+  forked child may still hold a copy of it.
+Works with cmdtab_build().
+*/
+void	cmdtab_reset(t_cmdtab *tab, t_vars *vars)
+{
+	if (tab->state != CMDTAB_NONE && tab->ifd >= 0)
+	{
+		if (tab->polled)
+			epoll_ctl(vars->events.epfd, EPOLL_CTL_DEL, tab->ifd, NULL);
+		close(tab->ifd);
+	}
+	ft_safefree((void **)&tab->path);
+	if (tab->dirs)
+		ft_free_2d(tab->dirs, ft_arrlen(tab->dirs));
+	tab->dirs = NULL;
+	ft_safefree((void **)&tab->slots);
+	ft_safefree((void **)&tab->names.data);
+	ft_memset(tab, 0, sizeof(t_cmdtab));
+	tab->ifd = -1;
+}
+
+/*
+Finds the slot of a name, or the free slot it would go in.
+- Linear probing from hash; the table is never more than half full,
+  so a probe sequence is short and always ends at a free slot.
+Returns:
+Index of the slot.
+Works with cmdtab_add() and cmdtab_find().
+*/
+int	cmdtab_slot(t_cmdtab *tab, const char *name, unsigned long hash)
+{
+	int	mask;
+	int	i;
+
+	mask = tab->cap - 1;
+	i = hash & mask;
+	while (tab->slots[i].name != -1 && (tab->slots[i].hash != hash
+			|| ft_strcmp(tab->names.data + tab->slots[i].name, name) != 0))
+		i = (i + 1) & mask;
+	return (i);
+}
+
+/*
+Doubles the number of hash slots (CMDTAB_MIN on first use).
+- Entries keep their hash, so rehashing compares no strings.
+Returns:
+1 on success, 0 on allocation failure (table left as it was).
+Works with cmdtab_add().
+*/
+int	cmdtab_grow(t_cmdtab *tab)
+{
+	t_cmdent	*old;
+	int			old_cap;
+	int			i;
+	int			j;
+
+	old = tab->slots;
+	old_cap = tab->cap;
+	tab->cap = CMDTAB_MIN;
+	if (old_cap)
+		tab->cap = old_cap * 2;
+	tab->slots = malloc(sizeof(t_cmdent) * tab->cap);
+	if (!tab->slots)
+	{
+		tab->slots = old;
+		tab->cap = old_cap;
+		return (0);
+	}
+	ft_memset(tab->slots, 0xff, sizeof(t_cmdent) * tab->cap);
+	i = -1;
+	while (++i < old_cap)
+	{
+		if (old[i].name == -1)
+			continue ;
+		j = old[i].hash & (tab->cap - 1);
+		while (tab->slots[j].name != -1)
+			j = (j + 1) & (tab->cap - 1);
+		tab->slots[j] = old[i];
+	}
+	free(old);
+	return (1);
+}
+
+/*
+Adds a name found in PATH directory dir.
+- A name already in the table is kept: the first directory in PATH
+  holding it wins, as in search_in_env().
+Returns:
+1 on success, 0 on allocation failure.
+Works with cmdtab_list().
+*/
+int	cmdtab_add(t_cmdtab *tab, char *name, int dir)
+{
+	unsigned long	hash;
+	int				i;
+
+	if ((tab->count + 1) * 2 > tab->cap && !cmdtab_grow(tab))
+		return (0);
+	hash = pcache_hash(name);
+	i = cmdtab_slot(tab, name, hash);
+	if (tab->slots[i].name != -1)
+		return (1);
+	tab->slots[i].hash = hash;
+	tab->slots[i].name = tab->names.len;
+	tab->slots[i].dir = dir;
+	if (!linebuf_add(&tab->names, 0, name))
+	{
+		tab->slots[i].name = -1;
+		return (0);
+	}
+	tab->names.len++;
+	tab->count++;
+	return (1);
+}
+
+/*
+Checks that a directory entry is a program that can be run.
+- Only regular files with an execute bit count, also behind a
+  symlink. Subdirectories (".", ".." too), sockets and data files
+  are left out.
+- d_type rules out directories and devices without a syscall, the
+  rest costs one fstatat().
+Returns:
+1 if the entry is an executable file, 0 otherwise.
+Works with cmdtab_list().
+*/
+int	cmdtab_exec(int dirfd, t_dirent64 *ent)
+{
+	struct stat	st;
+
+	if (ent->d_type != DT_REG && ent->d_type != DT_LNK
+		&& ent->d_type != DT_UNKNOWN)
+		return (0);
+	if (fstatat(dirfd, ent->d_name, &st, 0) == -1)
+		return (0);
+	return (S_ISREG(st.st_mode)
+		&& (st.st_mode & (S_IXUSR | S_IXGRP | S_IXOTH)));
+}
+
+/*
+Adds every program of one PATH directory to the table.
+- Reads the directory with raw getdents64() calls, DENTS_BUF_SZ
+  bytes of entries per call, without readdir()'s per-entry copying.
+- Only executable files are added (cmdtab_exec()), so a data file
+  earlier in PATH does not hide a program of the same name, as in bash.
+- A directory that cannot be opened adds nothing.
+Returns:
+1 on success, 0 on allocation failure.
+Works with cmdtab_build().
+*/
+int	cmdtab_list(t_cmdtab *tab, int dir)
+{
+	unsigned long long	buf[DENTS_BUF_SZ / sizeof(unsigned long long)];
+	t_dirent64			*ent;
+	long				n;
+	long				pos;
+	int					fd;
+	int					ok;
+
+	fd = open(tab->dirs[dir], O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd == -1)
+		return (1);
+	ok = 1;
+	n = syscall(SYS_getdents64, fd, buf, sizeof(buf));
+	while (ok && n > 0)
+	{
+		pos = 0;
+		while (ok && pos < n)
+		{
+			ent = (t_dirent64 *)((char *)buf + pos);
+			if (cmdtab_exec(fd, ent))
+				ok = cmdtab_add(tab, ent->d_name, dir);
+			pos += ent->d_reclen;
+		}
+		if (ok)
+			n = syscall(SYS_getdents64, fd, buf, sizeof(buf));
+	}
+	close(fd);
+	return (ok);
+}
+
+/*
+Sets up inotify watches on every PATH directory.
+- A directory that does not exist gets no watch. A program installed
+  there later is still found by the search_in_env() fallback.
+- At the terminal the descriptor joins the event loop's epoll set,
+  so changes are noticed while the prompt waits. Otherwise it is read
+  at each lookup (cmdtab_drain()).
+Returns:
+1 on success, 0 if inotify is unavailable.
+Works with cmdtab_build().
+*/
+int	cmdtab_watch(t_cmdtab *tab, t_vars *vars)
+{
+	struct epoll_event	reg;
+	int					i;
+
+	tab->ifd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (tab->ifd == -1)
+		return (0);
+	i = 0;
+	while (tab->dirs[i])
+		inotify_add_watch(tab->ifd, tab->dirs[i++], CMDTAB_WATCH | IN_ONLYDIR);
+	if (vars->input.mode == INPUT_TTY && vars->events.epfd >= 0)
+	{
+		reg.events = EPOLLIN;
+		reg.data.fd = tab->ifd;
+		tab->polled = (epoll_ctl(vars->events.epfd, EPOLL_CTL_ADD,
+					tab->ifd, &reg) == 0);
+	}
+	return (1);
+}
+
+/*
+Builds the command table for a PATH value.
+- Watches are set before the directories are listed, so a change made
+  while listing marks the table stale rather than getting lost.
+- A PATH with a relative entry is left unindexed (CMDTAB_OFF): what it
+  finds depends on the current directory.
+- Also CMDTAB_OFF if inotify or memory fails; the state is retried when
+  PATH changes.
+Works with cmdtab_find().
+
+Example: PATH=/usr/local/bin:/usr/bin
+- Watches both, lists both with getdents64()
+- "python3" in both maps to /usr/local/bin
+*/
+void	cmdtab_build(t_cmdtab *tab, char *path, t_vars *vars)
+{
+	int	ok;
+	int	i;
+
+	cmdtab_reset(tab, vars);
+	tab->path = ft_strdup(path);
+	tab->dirs = ft_split(path, ':');
+	if (!tab->path || !tab->dirs)
+	{
+		cmdtab_reset(tab, vars);
+		return ;
+	}
+	tab->state = CMDTAB_OFF;
+	i = 0;
+	while (tab->dirs[i] && tab->dirs[i][0] == '/')
+		i++;
+	if (tab->dirs[i] || !cmdtab_watch(tab, vars))
+		return ;
+	ok = 1;
+	i = 0;
+	while (ok && tab->dirs[i])
+		ok = cmdtab_list(tab, i++);
+	if (ok)
+		tab->state = CMDTAB_READY;
+}
+
+/*
+Reads pending inotify events and marks the table stale if there were any.
+- Nothing is looked at beyond "something changed": the table is rebuilt
+  on the next lookup, however many events a "make install" produced.
+Works with event_readline() and cmdtab_find().
+*/
+void	cmdtab_drain(t_cmdtab *tab)
+{
+	unsigned long long	buf[DENTS_BUF_SZ / sizeof(unsigned long long)];
+
+	if (tab->state == CMDTAB_NONE || tab->ifd < 0)
+		return ;
+	while (read(tab->ifd, buf, sizeof(buf)) > 0)
+		tab->state = CMDTAB_STALE;
+}
+
+/*
+Looks a command name up in the PATH command table.
+- At the terminal the table is built on first use. A script or -c
+  run first leaves CMDTAB_LAZY lookups to search_in_env(), so a short
+  run never lists PATH at all.
+- It is rebuilt when PATH changes or a watched directory changed.
+- At the terminal a lookup makes no syscalls: one scan of envp for
+  PATH, one hash and usually one string compare.
+- NULL only means "not in the table": the caller falls back to
+  search_in_env().
+- A background job's subshell shares the inotify descriptor with the
+  shell: it uses the table it inherited as long as that is current,
+  and never reads events or rebuilds.
+Returns:
+Full path of the command (caller frees), or NULL.
+Works with get_cmd_path().
+
+Example: "ls" twice, then "cp ./tool ~/bin/ && tool"
+- First "ls": lists PATH, returns "/usr/bin/ls"
+- Second "ls": hash lookup only
+- cp creates ~/bin/tool, inotify marks the table stale, "tool" is
+  found in the rebuilt table
+*/
+char	*cmdtab_find(char *cmd, char **envp, t_vars *vars)
+{
+	t_cmdtab	*tab;
+	char		*path;
+	char		*dir;
+	char		*full;
+	int			len;
+	int			i;
+
+	tab = &vars->cmdtab;
+	path = env_path(envp);
+	if (!path || !*cmd)
+		return (NULL);
+	if (!tab->polled && !vars->subshell)
+		cmdtab_drain(tab);
+	if (tab->state == CMDTAB_NONE || tab->state == CMDTAB_STALE
+		|| ft_strcmp(tab->path, path) != 0)
+	{
+		if (vars->subshell || (vars->input.mode != INPUT_TTY
+				&& ++tab->misses < CMDTAB_LAZY))
+			return (NULL);
+		cmdtab_build(tab, path, vars);
+	}
+	if (tab->state != CMDTAB_READY || !tab->count)
+		return (NULL);
+	i = cmdtab_slot(tab, cmd, pcache_hash(cmd));
+	if (tab->slots[i].name == -1)
+		return (NULL);
+	dir = tab->dirs[tab->slots[i].dir];
+	len = ft_strlen(dir);
+	full = malloc(len + ft_strlen(cmd) + 2);
+	if (!full)
+		return (NULL);
+	ft_memcpy(full, dir, len);
+	full[len] = '/';
+	ft_strlcpy(full + len + 1, cmd, ft_strlen(cmd) + 1);
+	return (full);
+}
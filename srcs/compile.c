@@ -0,0 +1,198 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   compile.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/25 13:40:02 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/25 13:40:02 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Appends one instruction to a program.
+- The code array doubles when full.
+Returns:
+1 on success, 0 on allocation failure.
+Works with compile_stage() and compile_ast().
+*/
+int	emit_insn(t_program *prog, int op, int node)
+{
+	t_insn	*grown;
+
+	if (prog->len == prog->cap)
+	{
+		grown = malloc(sizeof(t_insn) * (prog->cap * 2 + 8));
+		if (!grown)
+			return (0);
+		if (prog->len)
+			ft_memcpy(grown, prog->code, sizeof(t_insn) * prog->len);
+		free(prog->code);
+		prog->code = grown;
+		prog->cap = prog->cap * 2 + 8;
+	}
+	prog->code[prog->len].op = op;
+	prog->code[prog->len].node = node;
+	prog->len++;
+	return (1);
+}
+
+/*
+Flattens a tree of pipe nodes into its stages, left to right.
+- Works for pipes nested on either side.
+- The stage vector grows as needed, so any number of stages fits.
+Returns:
+1 on success, 0 on allocation failure.
+Works with compile_ast().
+
+Example: PIPE(a, PIPE(b, c))
+- prog->stage = {a, b, c}, prog->stages = 3
+*/
+int	collect_stages(t_program *prog, int node)
+{
+	if (node >= 0 && prog->ast->type[node] == TYPE_PIPE)
+		return (collect_stages(prog, prog->ast->left[node])
+			&& collect_stages(prog, prog->ast->right[node]));
+	if (!vec_reserve((void **)&prog->stage, &prog->stage_cap,
+			prog->stages + 1, sizeof(int)))
+		return (0);
+	prog->stage[prog->stages++] = node;
+	return (1);
+}
+
+/*
+Decides whether a stage runs in the shell instead of a child.
+- A lone command runs in the shell if it is a builtin, or if its name
+  needs expansion (the VM checks the expanded name at run time).
+- The last stage of a pipeline runs in the shell under the same rules
+  as is_parent_builtin_stage(): builtins that only write output.
+Returns:
+1 to emit OP_RUN_BUILTIN, 0 to emit OP_SPAWN.
+Works with compile_stage().
+*/
+int	stage_in_shell(t_program *prog, int stage, int cmd, int last)
+{
+	const t_builtin	*builtin;
+	t_flatast		*ast;
+	char			*name;
+
+	ast = prog->ast;
+	if (prog->stages > 1)
+	{
+		if (!last)
+			return (0);
+		while (stage >= 0 && (ast->type[stage] == TYPE_OUT_REDIRECT
+				|| ast->type[stage] == TYPE_APPEND_REDIRECT))
+			stage = ast->left[stage];
+		if (stage < 0 || stage != cmd)
+			return (0);
+		builtin = get_builtin(ast->argv[ast->arg_start[cmd]]);
+		return (builtin && builtin->in_parent && !builtin->needs_stdin);
+	}
+	if (cmd < 0)
+		return (1);
+	name = ast->argv[ast->arg_start[cmd]];
+	return (is_builtin(name) || ft_strchr(name, '$'));
+}
+
+/*
+Emits the instructions for one pipeline stage.
+- One OP_REDIR per redirection, in command-line order.
+- OP_EXPAND for the command words.
+- OP_PIPE if another stage follows.
+- OP_SPAWN or OP_RUN_BUILTIN to run it.
+Returns:
+1 on success, 0 on allocation failure.
+Works with compile_ast().
+
+Example: "grep x < in" as the first of two stages
+- REDIR(<), EXPAND(grep), PIPE, SPAWN(grep)
+*/
+int	compile_stage(t_program *prog, int stage, int last)
+{
+	t_flatast	*ast;
+	int			cmd;
+	int			ok;
+
+	ast = prog->ast;
+	cmd = stage;
+	ok = 1;
+	while (ok && cmd >= 0 && is_redirection(ast->type[cmd]))
+	{
+		ok = emit_insn(prog, OP_REDIR, cmd);
+		cmd = ast->left[cmd];
+	}
+	if (cmd >= 0 && (ast->type[cmd] != TYPE_CMD || !ast->arg_count[cmd]))
+		cmd = -1;
+	if (ok && cmd >= 0)
+		ok = emit_insn(prog, OP_EXPAND, cmd);
+	if (ok && !last)
+		ok = emit_insn(prog, OP_PIPE, -1);
+	if (ok && stage_in_shell(prog, stage, cmd, last))
+		return (emit_insn(prog, OP_RUN_BUILTIN, cmd));
+	if (ok)
+		return (emit_insn(prog, OP_SPAWN, cmd));
+	return (0);
+}
+
+/*
+Compiles a flat AST into a linear program for the VM.
+- The AST is only read: words are expanded at run time into fresh
+  argument vectors, so the program can be run again.
+- Instructions hold node indices, so the program must be freed
+  before the flat AST.
+Returns:
+Newly allocated program, or NULL if the tree cannot be compiled
+(unknown node, no memory); the caller then falls
+back to walking the tree.
+Works with run_flat().
+
+Example: "ls -l | wc -l > out"
+- 0 EXPAND(ls)  1 PIPE  2 SPAWN(ls)
+- 3 REDIR(>)  4 EXPAND(wc)  5 SPAWN(wc)  6 WAIT
+*/
+t_program	*compile_ast(t_flatast *ast)
+{
+	t_program	*prog;
+	int			stage;
+	int			i;
+
+	if (!ast || ast->root < 0)
+		return (NULL);
+	prog = ft_calloc(1, sizeof(t_program));
+	if (!prog)
+		return (NULL);
+	prog->ast = ast;
+	if (!collect_stages(prog, ast->root))
+		return (free_program(prog), NULL);
+	i = 0;
+	while (i < prog->stages)
+	{
+		stage = prog->stage[i];
+		if (stage < 0 || (ast->type[stage] != TYPE_CMD
+				&& !is_redirection(ast->type[stage]))
+			|| !compile_stage(prog, stage, i == prog->stages - 1))
+			return (free_program(prog), NULL);
+		i++;
+	}
+	if (!emit_insn(prog, OP_WAIT, -1))
+		return (free_program(prog), NULL);
+	return (prog);
+}
+
+/*
+Releases a compiled program.
+- The flat AST it indexes is not touched.
+Works with compile_ast() and run_flat().
+*/
+void	free_program(t_program *prog)
+{
+	if (!prog)
+		return ;
+	free(prog->code);
+	free(prog->stage);
+	free(prog);
+}
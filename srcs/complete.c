@@ -0,0 +1,198 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   complete.c                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/26 14:40:22 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:21:37 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Remembers the shell state for readline's completion callback.
+- Readline's completion hook takes no context pointer, so vars is
+  registered here once at startup.
+Returns:
+The registered vars (vars is stored if not NULL).
+Works with init_completion() and shell_completion().
+*/
+t_vars	*comp_vars(t_vars *vars)
+{
+	static t_vars	*current;
+
+	if (vars)
+		current = vars;
+	return (current);
+}
+
+/*
+Installs bleshell's tab completion in readline.
+- Replaces readline's default filename completer.
+- '$' no longer breaks words, so "$HO" reaches the completer whole.
+Works with init_shell().
+*/
+void	init_completion(t_vars *vars)
+{
+	comp_vars(vars);
+	rl_attempted_completion_function = shell_completion;
+	rl_basic_word_break_characters = COMP_BREAK_CHARS;
+}
+
+/*
+Appends one match to the current completion.
+- Takes ownership of match, which is freed if it cannot be stored.
+Returns:
+1 on success, 0 on allocation failure (or if match is NULL).
+Works with trie_collect(), comp_env() and dir_matches().
+*/
+int	comp_add(t_comp *comp, char *match)
+{
+	if (!match)
+		return (0);
+	if (!vec_reserve((void **)&comp->matches, &comp->cap, comp->count + 1,
+			sizeof(char *)))
+	{
+		free(match);
+		return (0);
+	}
+	comp->matches[comp->count++] = match;
+	return (1);
+}
+
+/*
+Checks if the word starting at start is in command position.
+- True at the start of the line and right after '|' or '&'.
+Returns:
+1 if a command name is expected there, 0 otherwise.
+Works with shell_completion().
+
+Example: "ls -l | gr"
+- "gr" (after '|') is a command, "-l" is not
+*/
+int	comp_cmd_pos(char *line, int start)
+{
+	while (start > 0 && ft_isspace(line[start - 1]))
+		start--;
+	return (start == 0 || line[start - 1] == '|' || line[start - 1] == '&');
+}
+
+/*
+Frees the collected matches.
+Works with comp_result().
+*/
+void	comp_drop(t_comp *comp)
+{
+	while (comp->count > 0)
+		free(comp->matches[--comp->count]);
+}
+
+/*
+Measures the longest prefix shared by all collected matches.
+Returns:
+Length of the common prefix.
+Works with comp_result().
+*/
+int	comp_lcd(t_comp *comp)
+{
+	int	lcd;
+	int	i;
+	int	j;
+
+	lcd = ft_strlen(comp->matches[0]);
+	i = 1;
+	while (i < comp->count && lcd > 0)
+	{
+		j = 0;
+		while (j < lcd && comp->matches[i][j] == comp->matches[0][j])
+			j++;
+		lcd = j;
+		i++;
+	}
+	return (lcd);
+}
+
+/*
+Turns the collected matches into the array readline expects.
+- [0] is the longest common prefix of all matches (the match itself
+  if there is only one), then the matches, then NULL.
+- Done here rather than through rl_completion_matches(), which grows
+  its array ten entries at a time.
+- The match strings move into the array, readline frees them.
+Returns:
+The match array, or NULL if there are no matches.
+Works with shell_completion().
+
+Example: matches "grep", "groups"
+- Returns {"gr", "grep", "groups", NULL}
+*/
+char	**comp_result(t_comp *comp)
+{
+	char	**result;
+
+	if (!comp->count)
+		return (NULL);
+	result = malloc(sizeof(char *) * (comp->count + 2));
+	if (result && comp->count == 1)
+	{
+		result[0] = comp->matches[0];
+		result[1] = NULL;
+		comp->count = 0;
+		return (result);
+	}
+	if (result)
+		result[0] = ft_strndup(comp->matches[0], comp_lcd(comp));
+	if (!result || !result[0])
+	{
+		free(result);
+		comp_drop(comp);
+		return (NULL);
+	}
+	ft_memcpy(result + 1, comp->matches, sizeof(char *) * comp->count);
+	result[comp->count + 1] = NULL;
+	comp->count = 0;
+	return (result);
+}
+
+/*
+Readline completion hook.
+- "$NAME": environment variable names.
+- A word in command position without '/': builtins and PATH
+  executables from the command trie, already in sorted order.
+- Anything else: file names from the directory cache.
+- Readline's sorting is set for every call: off for the trie, which
+  is sorted already, on for variables and files.
+- Never falls back to readline's own filename completion.
+Returns:
+Match array for readline, or NULL if nothing matches.
+Works with init_completion().
+
+Example: "ca<TAB>" then "cat sr<TAB>"
+- First: command trie, "cat" and any PATH entries starting with "ca"
+- Second: listing of ".", "srcs/" (readline adds the '/')
+*/
+char	**shell_completion(const char *text, int start, int end)
+{
+	t_vars	*vars;
+
+	(void)end;
+	vars = comp_vars(NULL);
+	rl_attempted_completion_over = 1;
+	rl_sort_completion_matches = 1;
+	if (text[0] == '$')
+		comp_env((char *)text, vars);
+	else if (!ft_strchr(text, '/') && comp_cmd_pos(rl_line_buffer, start))
+	{
+		rl_sort_completion_matches = 0;
+		comp_cmds((char *)text, vars);
+	}
+	else
+	{
+		rl_filename_completion_desired = 1;
+		comp_files((char *)text, vars);
+	}
+	return (comp_result(&vars->comp));
+}
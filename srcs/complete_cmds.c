@@ -0,0 +1,332 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   complete_cmds.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/26 14:40:22 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 14:40:22 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Finds or adds the child of a trie node for one character.
+- Siblings stay sorted by character, a new node is linked in place.
+- Nodes are addressed by index, so growing the vector is safe.
+Returns:
+Index of the child node, or -1 on allocation failure.
+Works with trie_add().
+*/
+int	trie_child(t_trie *trie, int parent, char c)
+{
+	int	prev;
+	int	cur;
+
+	prev = -1;
+	cur = trie->nodes[parent].child;
+	while (cur != -1 && (unsigned char)trie->nodes[cur].c < (unsigned char)c)
+	{
+		prev = cur;
+		cur = trie->nodes[cur].next;
+	}
+	if (cur != -1 && trie->nodes[cur].c == c)
+		return (cur);
+	if (!vec_reserve((void **)&trie->nodes, &trie->cap, trie->count + 1,
+			sizeof(t_trienode)))
+		return (-1);
+	trie->nodes[trie->count].c = c;
+	trie->nodes[trie->count].child = -1;
+	trie->nodes[trie->count].next = cur;
+	trie->nodes[trie->count].word = 0;
+	if (prev == -1)
+		trie->nodes[parent].child = trie->count;
+	else
+		trie->nodes[prev].next = trie->count;
+	return (trie->count++);
+}
+
+/*
+Adds a name to the trie.
+- The root node is created on first use.
+- Adding a name twice is harmless.
+Returns:
+1 on success, 0 on allocation failure.
+Works with path_index_build().
+*/
+int	trie_add(t_trie *trie, const char *word)
+{
+	int	node;
+
+	if (!trie->count)
+	{
+		if (!vec_reserve((void **)&trie->nodes, &trie->cap, 1,
+				sizeof(t_trienode)))
+			return (0);
+		ft_memset(trie->nodes, 0, sizeof(t_trienode));
+		trie->nodes[0].child = -1;
+		trie->nodes[0].next = -1;
+		trie->count = 1;
+	}
+	node = 0;
+	while (*word)
+	{
+		node = trie_child(trie, node, *word++);
+		if (node < 0)
+			return (0);
+	}
+	trie->nodes[node].word = 1;
+	return (1);
+}
+
+/*
+Walks the trie along a prefix.
+Returns:
+Index of the node the prefix ends at, or -1 if no name starts with it.
+Works with comp_cmds().
+*/
+int	trie_find(t_trie *trie, const char *prefix)
+{
+	int	node;
+
+	if (!trie->count)
+		return (-1);
+	node = 0;
+	while (*prefix)
+	{
+		node = trie->nodes[node].child;
+		while (node != -1 && trie->nodes[node].c != *prefix)
+			node = trie->nodes[node].next;
+		if (node == -1)
+			return (-1);
+		prefix++;
+	}
+	return (node);
+}
+
+/*
+Adds every name below a trie node to the current completion.
+- word holds the name spelled so far (the prefix on the first call)
+  and must have room for NAME_MAX characters.
+- Names come out in strcmp() order.
+Works with comp_cmds().
+
+Example: Trie with "grep", "groups", node reached by "gr"
+- Adds "grep", then "groups"
+*/
+void	trie_collect(t_trie *trie, int node, t_linebuf *word, t_comp *comp)
+{
+	int	child;
+	int	len;
+
+	if (trie->nodes[node].word
+		&& !comp_add(comp, ft_strndup(word->data, word->len)))
+		return ;
+	len = word->len;
+	child = trie->nodes[node].child;
+	while (child != -1 && len < word->cap - 1)
+	{
+		word->data[len] = trie->nodes[child].c;
+		word->len = len + 1;
+		trie_collect(trie, child, word, comp);
+		child = trie->nodes[child].next;
+	}
+	word->len = len;
+}
+
+/*
+Reads the mtime of a directory.
+- A directory that cannot be stat()ed gets a zero time.
+Works with path_index_stale() and path_index_build().
+*/
+void	dir_mtime(const char *dir, struct timespec *mtime)
+{
+	struct stat	st;
+
+	if (stat(dir, &st) == -1)
+		ft_memset(mtime, 0, sizeof(struct timespec));
+	else
+		*mtime = st.st_mtim;
+}
+
+/*
+Checks if the command trie still matches PATH.
+- Stale if never built, if the PATH directories changed, or if any
+  of them was modified (a program added, removed or renamed).
+- Costs one stat() per PATH directory.
+Returns:
+1 if the trie must be rebuilt, 0 if it is current.
+Works with comp_cmds().
+*/
+int	path_index_stale(t_comp *comp, char **dirs)
+{
+	struct timespec	now;
+	int				i;
+
+	if (!comp->cmds.count || !dirs != !comp->dirs)
+		return (1);
+	i = 0;
+	while (dirs && dirs[i] && comp->dirs[i])
+	{
+		if (ft_strcmp(dirs[i], comp->dirs[i]) != 0)
+			return (1);
+		dir_mtime(dirs[i], &now);
+		if (now.tv_sec != comp->mtimes[i].tv_sec
+			|| now.tv_nsec != comp->mtimes[i].tv_nsec)
+			return (1);
+		i++;
+	}
+	return (dirs && (dirs[i] || comp->dirs[i]));
+}
+
+/*
+Adds the programs of one PATH directory to the command trie.
+- Entries that are directories, hidden or not executable are skipped.
+- A directory that cannot be opened adds nothing.
+Returns:
+1 on success, 0 on allocation failure.
+Works with path_index_build().
+*/
+int	path_index_dir(t_trie *trie, char *path)
+{
+	DIR				*dir;
+	struct dirent	*ent;
+	int				ok;
+
+	dir = opendir(path);
+	if (!dir)
+		return (1);
+	ok = 1;
+	ent = readdir(dir);
+	while (ent && ok)
+	{
+		if (ent->d_type != DT_DIR && ent->d_name[0] != '.'
+			&& faccessat(dirfd(dir), ent->d_name, X_OK, 0) == 0)
+			ok = trie_add(trie, ent->d_name);
+		ent = readdir(dir);
+	}
+	closedir(dir);
+	return (ok);
+}
+
+/*
+Rebuilds the command trie from the builtins and PATH.
+- Takes ownership of dirs (from get_path_env(), may be NULL).
+- Each directory's mtime is read before it is listed, so a change
+  made while listing shows up as stale next time.
+Returns:
+1 on success, 0 on allocation failure (trie left empty, so the next
+completion tries again).
+Works with comp_cmds().
+
+Example: PATH=/usr/bin:/bin
+- Adds "cd", "echo", ... then all of /usr/bin and /bin
+*/
+int	path_index_build(t_comp *comp, char **dirs)
+{
+	const t_builtin	*table;
+	int				ok;
+	int				i;
+
+	comp->cmds.count = 0;
+	if (comp->dirs)
+		ft_free_2d(comp->dirs, ft_arrlen(comp->dirs));
+	free(comp->mtimes);
+	comp->dirs = dirs;
+	comp->mtimes = NULL;
+	if (dirs)
+	{
+		comp->mtimes = malloc(sizeof(struct timespec)
+				* (ft_arrlen(dirs) + 1));
+		if (!comp->mtimes)
+			return (0);
+	}
+	ok = 1;
+	table = builtin_table();
+	i = -1;
+	while (ok && ++i < BUILTIN_SLOTS)
+		if (table[i].name)
+			ok = trie_add(&comp->cmds, table[i].name);
+	i = 0;
+	while (ok && dirs && dirs[i])
+	{
+		dir_mtime(dirs[i], &comp->mtimes[i]);
+		ok = path_index_dir(&comp->cmds, dirs[i++]);
+	}
+	if (!ok)
+		comp->cmds.count = 0;
+	return (ok);
+}
+
+/*
+Collects builtins and PATH executables starting with text.
+- The trie is rebuilt only when PATH or one of its directories
+  changed since the last completion.
+Works with shell_completion().
+
+Example: "gr<TAB>"
+- One stat() per PATH directory, one walk down "g", "r"
+- Adds "grep", "groups", ... in sorted order
+*/
+void	comp_cmds(char *text, t_vars *vars)
+{
+	char		buf[NAME_MAX + 1];
+	t_linebuf	word;
+	char		**dirs;
+	int			node;
+
+	dirs = get_path_env(vars->env);
+	if (!path_index_stale(&vars->comp, dirs))
+	{
+		if (dirs)
+			ft_free_2d(dirs, ft_arrlen(dirs));
+	}
+	else if (!path_index_build(&vars->comp, dirs))
+		return ;
+	if (ft_strlen(text) > NAME_MAX)
+		return ;
+	node = trie_find(&vars->comp.cmds, text);
+	if (node < 0)
+		return ;
+	word.data = buf;
+	word.len = ft_strlcpy(buf, text, sizeof(buf));
+	word.cap = sizeof(buf);
+	trie_collect(&vars->comp.cmds, node, &word, &vars->comp);
+}
+
+/*
+Collects environment variable names for a "$NAME" word.
+- Matches are returned with their '$', so the word is replaced whole.
+Works with shell_completion().
+
+Example: "$HO<TAB>"
+- Adds "$HOME" (and "$HOSTNAME" if set)
+*/
+void	comp_env(char *text, t_vars *vars)
+{
+	char	*eq;
+	char	*match;
+	int		len;
+	int		i;
+
+	len = ft_strlen(text + 1);
+	i = 0;
+	while (vars->env && vars->env[i])
+	{
+		eq = ft_strchr(vars->env[i], '=');
+		if (eq && eq - vars->env[i] >= len
+			&& ft_strncmp(vars->env[i], text + 1, len) == 0)
+		{
+			match = malloc(eq - vars->env[i] + 2);
+			if (!match)
+				return ;
+			match[0] = '$';
+			ft_strlcpy(match + 1, vars->env[i], eq - vars->env[i] + 1);
+			if (!comp_add(&vars->comp, match))
+				return ;
+		}
+		i++;
+	}
+}
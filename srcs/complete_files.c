@@ -0,0 +1,213 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   complete_files.c                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/26 14:40:22 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 14:40:22 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Frees a directory listing and marks its slot free.
+Works with dir_listing().
+*/
+void	dir_free(t_dirlist *list)
+{
+	ft_safefree((void **)&list->path);
+	ft_safefree((void **)&list->names);
+	ft_safefree((void **)&list->text.data);
+	list->text.len = 0;
+	list->text.cap = 0;
+	list->count = 0;
+}
+
+/*
+Lists a directory into an empty slot.
+- All names are copied into one buffer (NUL separated), so a listing
+  is two allocations however many entries it has.
+- "." and ".." are left out.
+- Names stay in directory order. Sorting 100k names costs more than
+  the readdir() itself, while a prefix scan over them is well under a
+  millisecond.
+Returns:
+1 on success, 0 if the directory cannot be read or memory runs out.
+Works with dir_listing().
+*/
+int	dir_read(t_dirlist *list, char *path)
+{
+	DIR				*dir;
+	struct dirent	*ent;
+	char			*name;
+	int				i;
+
+	dir = opendir(path);
+	if (!dir)
+		return (0);
+	ent = readdir(dir);
+	while (ent)
+	{
+		if (ft_strcmp(ent->d_name, ".") && ft_strcmp(ent->d_name, ".."))
+		{
+			if (!linebuf_add(&list->text, 0, ent->d_name))
+				break ;
+			list->text.len++;
+			list->count++;
+		}
+		ent = readdir(dir);
+	}
+	closedir(dir);
+	if (ent)
+		return (0);
+	list->names = malloc(sizeof(char *) * (list->count + 1));
+	if (!list->names)
+		return (0);
+	name = list->text.data;
+	i = 0;
+	while (i < list->count)
+	{
+		list->names[i++] = name;
+		name += ft_strlen(name) + 1;
+	}
+	return (1);
+}
+
+/*
+Returns the listing of a directory, reading it only when needed.
+- A cached listing is reused as long as the directory's mtime is
+  unchanged; creating, removing or renaming an entry changes it.
+- A new listing takes a free slot, or evicts the least recently used.
+Returns:
+The listing, or NULL if path is not a readable directory.
+Works with comp_files().
+
+Example: "ls big/f<TAB>" twice on a directory with 100k entries
+- First: one stat(), readdir() of all entries
+- Second: one stat(), one prefix scan over the cached names
+*/
+t_dirlist	*dir_listing(t_comp *comp, char *path)
+{
+	struct stat	st;
+	t_dirlist	*list;
+	int			i;
+
+	if (stat(path, &st) == -1 || !S_ISDIR(st.st_mode))
+		return (NULL);
+	list = &comp->cache[0];
+	i = 0;
+	while (i < COMP_DIR_SLOTS && !(comp->cache[i].path
+			&& ft_strcmp(comp->cache[i].path, path) == 0))
+	{
+		if (list->path && (!comp->cache[i].path
+				|| comp->cache[i].stamp < list->stamp))
+			list = &comp->cache[i];
+		i++;
+	}
+	if (i < COMP_DIR_SLOTS)
+		list = &comp->cache[i];
+	list->stamp = ++comp->clock;
+	if (i < COMP_DIR_SLOTS && list->mtime.tv_sec == st.st_mtim.tv_sec
+		&& list->mtime.tv_nsec == st.st_mtim.tv_nsec)
+		return (list);
+	dir_free(list);
+	list->path = ft_strdup(path);
+	if (!list->path || !dir_read(list, path))
+	{
+		dir_free(list);
+		return (NULL);
+	}
+	list->mtime = st.st_mtim;
+	return (list);
+}
+
+/*
+Collects the entries of a listing that start with prefix.
+- Most names differ from the prefix in the first byte, so the scan
+  is a few nanoseconds per entry.
+- Hidden entries only match a prefix starting with '.'.
+- Each match is dir followed by the entry name, as typed.
+Works with comp_files().
+
+Example: dir "srcs/", prefix "pi", listing of srcs
+- Adds "srcs/pipe_size.c", "srcs/pipeline.c", ... in directory order
+- readline sorts them for display
+*/
+void	dir_matches(t_dirlist *list, char *dir, char *prefix, t_comp *comp)
+{
+	int	len;
+	int	i;
+
+	len = ft_strlen(prefix);
+	i = 0;
+	while (i < list->count)
+	{
+		if (ft_strncmp(list->names[i], prefix, len) == 0
+			&& (list->names[i][0] != '.' || prefix[0] == '.')
+			&& !comp_add(comp, ft_strjoin(dir, list->names[i])))
+			return ;
+		i++;
+	}
+}
+
+/*
+Turns the directory part of a word into a path to list.
+- An empty directory part means the current directory.
+- A leading "~/" is replaced with $HOME.
+Returns:
+The path (caller frees), or NULL on allocation failure.
+Works with comp_files().
+*/
+char	*comp_dir_path(char *dir, t_vars *vars)
+{
+	char	*home;
+	char	*path;
+
+	if (!*dir)
+		return (ft_strdup("."));
+	if (dir[0] != '~' || dir[1] != '/')
+		return (ft_strdup(dir));
+	home = get_env_val("HOME", vars->env);
+	if (!home)
+		return (ft_strdup(dir));
+	path = ft_strjoin(home, dir + 1);
+	free(home);
+	return (path);
+}
+
+/*
+Collects file names for the word being completed.
+- The word is split at its last '/': the directory part is listed
+  (through the cache), the rest is the prefix to match.
+Works with shell_completion().
+
+Example: "cat ~/Doc<TAB>"
+- Lists $HOME/ and matches "Doc"
+- Adds "~/Documents" (readline appends the '/')
+*/
+void	comp_files(char *text, t_vars *vars)
+{
+	char		*slash;
+	char		*dir;
+	char		*path;
+	t_dirlist	*list;
+
+	slash = ft_strrchr(text, '/');
+	if (slash)
+		dir = ft_strndup(text, slash - text + 1);
+	else
+		dir = ft_strdup("");
+	if (!dir)
+		return ;
+	path = comp_dir_path(dir, vars);
+	list = NULL;
+	if (path)
+		list = dir_listing(&vars->comp, path);
+	if (list)
+		dir_matches(list, dir, text + ft_strlen(dir), &vars->comp);
+	free(path);
+	free(dir);
+}
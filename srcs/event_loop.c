@@ -0,0 +1,142 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   event_loop.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/24 18:02:44 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 18:47:36 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Remembers which event state the readline callback should fill in.
+- Readline's line handler takes no context pointer, so the state is
+  registered here before the handler is installed.
+Returns:
+The registered state (ev is stored if not NULL).
+Works with event_readline() and event_line_handler().
+*/
+t_events	*event_state(t_events *ev)
+{
+	static t_events	*current;
+
+	if (ev)
+		current = ev;
+	return (current);
+}
+
+/*
+Readline callback for a completed line.
+- Stores the line (NULL on Ctrl+D) and ends the event loop.
+- Removes the handler, so the prompt is not redrawn after Enter.
+Works with event_readline().
+*/
+void	event_line_handler(char *line)
+{
+	t_events	*ev;
+
+	ev = event_state(NULL);
+	ev->line = line;
+	ev->done = 1;
+	rl_callback_handler_remove();
+}
+
+/*
+Reads one line from the terminal through the shell's event loop.
+- Readline runs in callback mode: it only gets a character when
+  epoll reports the terminal readable.
+- The same epoll set carries the signalfd, so Ctrl+C, child exits
+  and window resizes are handled between keystrokes, synchronously.
+- It also carries the PATH watches of the command table, so a program
+  installed while the prompt waits marks the table stale, and the
+  history loader's eventfd, so its lines are merged as soon as read.
+- A Ctrl+C that arrived while a command ran was meant for that
+  command: it only moves the new prompt to a fresh line.
+- At the main prompt, a pause of SPEC_IDLE_MS after a keystroke
+  parses the line typed so far (spec_parse()), so Enter can run it
+  straight from the parse cache.
+- Falls back to plain readline() if the event loop is unavailable.
+Returns:
+The line read (caller frees), or NULL on Ctrl+D.
+Works with shell_readline().
+
+Example: "sleep 1 &" then typing slowly
+- SIGCHLD wakes the loop, the job is reaped while the user types
+- Readline keeps the partial line untouched
+*/
+char	*event_readline(const char *prompt, t_vars *vars)
+{
+	struct epoll_event	evs[EVENTS_MAX];
+	t_events			*ev;
+	int					idle;
+	int					n;
+
+	ev = &vars->events;
+	if (ev->epfd < 0)
+		return (readline(prompt));
+	event_state(ev);
+	handle_signals(vars, read_signals(vars) & ~(1 << SIGINT));
+	if (g_signal_received)
+		write(STDOUT_FILENO, "\n", 1);
+	g_signal_received = 0;
+	ev->line = NULL;
+	ev->done = 0;
+	rl_callback_handler_install(prompt, event_line_handler);
+	idle = -1;
+	while (!ev->done)
+	{
+		n = epoll_wait(ev->epfd, evs, EVENTS_MAX, idle);
+		if (n == -1 && errno != EINTR)
+		{
+			rl_callback_handler_remove();
+			return (NULL);
+		}
+		if (n == 0)
+			spec_parse(rl_line_buffer, vars);
+		idle = -1;
+		while (n-- > 0 && !ev->done)
+		{
+			if (evs[n].data.fd == ev->sigfd)
+				handle_signals(vars, read_signals(vars));
+			else if (vars->cmdtab.polled
+				&& evs[n].data.fd == vars->cmdtab.ifd)
+				cmdtab_drain(&vars->cmdtab);
+			else if (vars->hist.epfd >= 0
+				&& evs[n].data.fd == vars->hist.efd)
+				hist_merge(&vars->hist);
+			else
+			{
+				rl_callback_read_char();
+				if (ev->speculate)
+					idle = SPEC_IDLE_MS;
+			}
+		}
+	}
+	return (ev->line);
+}
+
+/*
+Sleeps until a signal arrives on the signalfd.
+- Used by blocking builtins (wait, fg) instead of blocking syscalls,
+  since the shell's signals are blocked and cannot cause EINTR.
+- A Ctrl+C caught by sigint_handler() (builtin running with SIGINT
+  unblocked) ends the poll with EINTR and counts as SIGINT too.
+Returns:
+Bitmask of the signals read, see read_signals().
+Works with wait_job().
+*/
+int	wait_signal(t_vars *vars)
+{
+	struct pollfd	pfd;
+
+	pfd.fd = vars->events.sigfd;
+	pfd.events = POLLIN;
+	poll(&pfd, 1, -1);
+	if (g_signal_received)
+		return (read_signals(vars) | (1 << SIGINT));
+	return (read_signals(vars));
+}
@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/01 22:26:13 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/20 04:07:10 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 20:05:40 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -128,22 +128,43 @@ int	setup_redirection(t_node *node, t_vars *vars, int *fd)
     return (0);
 }
 
+/*
+Finds the command wrapped by a chain of redirection nodes.
+- Follows left children while they are redirections.
+Returns:
+The innermost command node, or NULL if the chain is broken.
+Works with exec_redirect_cmd().
+*/
+t_node	*get_redir_cmd(t_node *node)
+{
+    while (node && is_redirection(node->type))
+        node = node->left;
+    return (node);
+}
+
 /*
 Executes a command with redirection.
-- Saves original file descriptors.
-- Sets up redirection according to node type.
-- Executes the command with redirection in place.
-- Restores original file descriptors afterward.
+- Builtins are handed the opened files through an I/O context.
+- External commands get all their redirections as one fd plan,
+  applied in the child after fork.
+- The shell's own descriptors are never touched.
+- The command's parsed words are swapped for their expansion only
+  while it runs.
 Returns:
 Result of command execution.
 Works with execute_cmd().
+
+Example: For "grep a < in > out"
+- Plan is {stdin <- "in", stdout <- "out"}
+- Child opens and dup2()s both, then calls execve()
 */
 int	exec_redirect_cmd(t_node *node, char **envp, t_vars *vars)
 {
-    int	saved_stdout;
-    int	saved_stdin;
-    int	fd;
-    int	result;
+    t_fdplan	plan;
+    t_node		*cmd;
+    t_arena		arena;
+    char		**parsed;
+    int			result;
 
     fprintf(stderr, "DEBUG: Executing redirection %s\n", 
         get_token_str(node->type));
@@ -152,31 +173,44 @@ int	exec_redirect_cmd(t_node *node, char **envp, t_vars *vars)
         fprintf(stderr, "DEBUG: Invalid redirection node structure\n");
         return (1);
     }
-    saved_stdout = dup(STDOUT_FILENO);
-    saved_stdin = dup(STDIN_FILENO);
-    fd = -1;
-    if (!setup_redirection(node, vars, &fd))
+    cmd = get_redir_cmd(node);
+    if (!cmd || cmd->type != TYPE_CMD || !cmd->args || !cmd->args[0])
         return (1);
-    result = execute_cmd(node->left, envp, vars);
-    fprintf(stderr, "DEBUG: Restoring original file descriptors\n");
-    dup2(saved_stdout, STDOUT_FILENO);
-    dup2(saved_stdin, STDIN_FILENO);
-    cleanup_fds(saved_stdout, saved_stdin);
-    if (fd > 2)
-        close(fd);
+    if (is_builtin(cmd->args[0]))
+        return (exec_redirect_builtin(node, vars));
+    if (!build_fdplan(node, &plan, vars))
+    {
+        vars->error_code = 1;
+        return (vars->error_code);
+    }
+    arena_init(&arena);
+    parsed = cmd->args;
+    cmd->args = expand_argv(cmd, &arena, vars);
+    if (!cmd->args)
+    {
+        cmd->args = parsed;
+        close_fdplan(&plan);
+        return (1);
+    }
+    print_cmd_args(cmd);
+    result = exec_external_cmd(cmd, envp, vars, &plan);
+    cmd->args = parsed;
+    arena_free(&arena);
     return (result);
 }
 
 /*
 Executes a child process for external commands.
 - Forks a child process.
-- In child: executes the external command.
-- In parent: waits for child and processes exit status.
+- In child: applies the fd plan (if any), then executes the command.
+- In parent: releases plan descriptors, waits and processes exit status.
+  A child stopped with Ctrl+Z goes to the job table.
 Returns:
 Exit code from the command execution.
 Works with execute_cmd().
 */
-int	exec_child_cmd(t_node *node, char **envp, t_vars *vars, char *cmd_path)
+int	exec_child_cmd(t_node *node, t_vars *vars, char *cmd_path,
+        t_fdplan *plan)
 {
     pid_t	pid;
     int		status;
@@ -184,14 +218,21 @@ int	exec_child_cmd(t_node *node, char **envp, t_vars *vars, char *cmd_path)
     pid = fork();
     if (pid == 0)
     {
+        join_job_pgrp(vars, 1);
+        reset_child_signals();
         fprintf(stderr, "DEBUG: Child process executing: %s\n", cmd_path);
-        if (execve(cmd_path, node->args, envp) == -1)
+        if (plan && !apply_fdplan(plan, vars))
+            exit(1);
+        if (execve(cmd_path, node->args, vars->env) == -1)
         {
             perror("bleshell");
             exit(1);
         }
     }
-    else if (pid < 0)
+    track_job_pgrp(vars, pid, 1);
+    if (plan)
+        close_fdplan(plan);
+    if (pid < 0)
     {
         perror("bleshell: fork");
         ft_safefree((void **)&cmd_path);
@@ -199,8 +240,13 @@ int	exec_child_cmd(t_node *node, char **envp, t_vars *vars, char *cmd_path)
     }
     else
     {
-        waitpid(pid, &status, 0);
+        if (vars->job_control && !vars->subshell)
+            waitpid(pid, &status, WUNTRACED);
+        else
+            waitpid(pid, &status, 0);
         ft_safefree((void **)&cmd_path);
+        if (WIFSTOPPED(status))
+            return (stop_job(vars, pid, 1, status));
         return (handle_cmd_status(status, vars));
     }
     return (0);
@@ -229,9 +275,98 @@ void	print_cmd_args(t_node *node)
     fprintf(stderr, "\n");
 }
 
+/*
+Checks if the current command line is the last thing this shell will
+ever do.
+- Only in batch mode (-c, script or piped stdin) or in a subshell
+  forked for a background job.
+- In batch mode no more commands may follow in the input.
+Returns:
+1 if the shell may be replaced, 0 otherwise.
+Works with is_final_cmd() and vm_spawn().
+*/
+int	can_replace_shell(t_vars *vars)
+{
+    if (vars->subshell)
+        return (1);
+    if (vars->input.mode != INPUT_BATCH)
+        return (0);
+    return (batch_is_last(&vars->input));
+}
+
+/*
+Checks if a command is the last thing this shell will ever do.
+- Command must be the whole AST: not part of a pipeline, possibly
+  wrapped in redirections.
+- The shell must be about to finish, see can_replace_shell().
+Returns:
+1 if the shell may execve() the command in place, 0 otherwise.
+Works with exec_external_cmd().
+
+Example: bleshell -c "make test"
+- "make" is the AST root and the -c string is used up
+- Returns 1, so the shell becomes make instead of forking it
+*/
+int	is_final_cmd(t_node *node, t_vars *vars)
+{
+    if (get_redir_cmd(vars->astroot) != node)
+        return (0);
+    return (can_replace_shell(vars));
+}
+
+/*
+Replaces the shell with the final command.
+- Applies the fd plan in this process, there is no child.
+- Frees nothing: the process image is replaced on success.
+Returns:
+Never returns (execve() or exit()).
+Works with exec_external_cmd().
+*/
+void	exec_in_place(t_node *node, t_vars *vars, char *cmd_path,
+        t_fdplan *plan)
+{
+    if (plan && !apply_fdplan(plan, vars))
+        exit(1);
+    reset_child_signals();
+    execve(cmd_path, node->args, vars->env);
+    perror("bleshell");
+    exit(126);
+}
+
+/*
+Resolves and runs an external command.
+- Looks the command up in PATH.
+- Reports "command not found" with status 127.
+- The final command of a batch run replaces the shell (no fork).
+- Otherwise forks and executes it with the given fd plan.
+Returns:
+Exit code from the command execution.
+Works with exec_std_cmd() and exec_redirect_cmd().
+*/
+int	exec_external_cmd(t_node *node, char **envp, t_vars *vars,
+        t_fdplan *plan)
+{
+    char	*cmd_path;
+
+    cmd_path = get_cmd_path(node->args[0], envp, vars);
+    if (!cmd_path)
+    {
+        if (plan)
+            close_fdplan(plan);
+        ft_putstr_fd("bleshell: command not found: ", 2);
+        ft_putendl_fd(node->args[0], 2);
+        vars->error_code = 127;
+        return (vars->error_code);
+    }
+    if (is_final_cmd(node, vars))
+        exec_in_place(node, vars, cmd_path, plan);
+    return (exec_child_cmd(node, vars, cmd_path, plan));
+}
+
 /*
 Handles standard command execution.
-- Expands command arguments (variables, etc).
+- Expands command arguments (variables, etc) into scratch memory;
+  node->args is put back afterwards, so the node can run again.
 - Checks if command is a builtin and handles accordingly.
 - For external commands: finds path and executes.
 Returns:
@@ -240,41 +375,73 @@ Works with execute_cmd().
 */
 int	exec_std_cmd(t_node *node, char **envp, t_vars *vars)
 {
-    char	*cmd_path;
+    const t_builtin	*builtin;
+    t_io			io;
+    t_arena			arena;
+    char			**parsed;
+    int				result;
 
     if (!node->args || !node->args[0])
     {
         fprintf(stderr, "DEBUG: Invalid command node or missing arguments\n");
         return (1);
     }
-    expand_cmd_args(node, vars);
+    arena_init(&arena);
+    parsed = node->args;
+    node->args = expand_argv(node, &arena, vars);
+    if (!node->args)
+    {
+        node->args = parsed;
+        return (1);
+    }
     print_cmd_args(node);
-    if (is_builtin(node->args[0]))
+    builtin = get_builtin(node->args[0]);
+    if (builtin)
     {
         fprintf(stderr, "DEBUG: Executing builtin command: %s\n", 
             node->args[0]);
-        return (execute_builtin(node->args[0], node->args, vars));
-    }
-    cmd_path = get_cmd_path(node->args[0], envp);
-    if (!cmd_path)
-    {
-        ft_putstr_fd("bleshell: command not found: ", 2);
-        ft_putendl_fd(node->args[0], 2);
-        vars->error_code = 127;
-        return (vars->error_code);
+        init_io(&io, STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO);
+        builtin_interrupts(1);
+        result = builtin->fn(node->args, vars, &io);
+        builtin_interrupts(0);
+        io_flush(&io);
+        vars->error_code = result;
     }
-    fprintf(stderr, "DEBUG: Found command path: %s\n", cmd_path);
-    return (exec_child_cmd(node, envp, vars, cmd_path));
+    else
+        result = exec_external_cmd(node, envp, vars, NULL);
+    node->args = parsed;
+    arena_free(&arena);
+    return (result);
+}
+
+/*
+Compiles a flat AST and runs it on the VM.
+Returns:
+Exit status of the command line, or -1 if the AST cannot be
+compiled (nothing was run).
+Works with execute_cmd() and execute_ast().
+*/
+int	run_flat(t_flatast *ast, t_vars *vars)
+{
+    t_program	*prog;
+    int			result;
+
+    prog = compile_ast(ast);
+    if (!prog)
+        return (-1);
+    result = vm_run(prog, vars);
+    free_program(prog);
+    return (result);
 }
 
 /*
 Master function to execute commands based on node type.
-- Handles various node types (cmd, pipe, redirections).
-- Routes execution to appropriate handlers.
-- Ensures proper cleanup after execution.
+- Flattens the tree, compiles it and runs it on the VM.
+- If the tree cannot be compiled, falls back to walking it:
+  routes each node type (cmd, pipe, redirections) to its handler.
 Returns:
 Exit status of the executed command.
-Works with process_command() in main execution loop.
+Works with execute_ast() and the tree-walking executors.
 
 Example: For input "ls -l | grep foo > output.txt":
 - First executes the pipeline with ls and grep
@@ -283,11 +450,19 @@ Example: For input "ls -l | grep foo > output.txt":
 */
 int	execute_cmd(t_node *node, char **envp, t_vars *vars)
 {
+    t_flatast	*ast;
+    int			result;
+
     if (!node)
     {
         fprintf(stderr, "DEBUG: NULL command node\n");
         return (1);
     }
+    ast = flatten_ast(node);
+    result = run_flat(ast, vars);
+    free(ast);
+    if (result >= 0)
+        return (result);
     fprintf(stderr, "DEBUG: Executing %s node: %p\n",
         get_token_str(node->type), (void *)node);
     if (node->type == TYPE_PIPE)
@@ -302,3 +477,23 @@ int	execute_cmd(t_node *node, char **envp, t_vars *vars)
     }
     return (exec_std_cmd(node, envp, vars));
 }
+
+/*
+Executes the current command line.
+- Runs vars->flat, the flat AST built once by build_and_execute()
+  or taken from the parse cache.
+- Falls back to execute_cmd() on the tree if there is no flat AST
+  or it cannot be compiled.
+Returns:
+Exit status of the command line.
+Works with run_ast() and launch_job().
+*/
+int	execute_ast(t_vars *vars)
+{
+    int	result;
+
+    result = run_flat(vars->flat, vars);
+    if (result >= 0)
+        return (result);
+    return (execute_cmd(vars->astroot, vars->env, vars));
+}
@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/01 23:01:47 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 07:50:49 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/25 22:31:06 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -105,7 +105,7 @@ char	*get_var_name(char *input, int *pos)
     start = *pos;
     while (input[*pos] && (ft_isalnum(input[*pos]) || input[*pos] == '_'))
         (*pos)++;
-    var_name = ft_substr(input, start, *pos - start);
+    var_name = ft_strndup(input + start, *pos - start);
     return (var_name);
 }
 
@@ -285,49 +285,3 @@ void	expand_cmd_args(t_node *node, t_vars *vars)
     }
 }
 */
-/*
-Expands environment variables in command arguments.
-- Processes each argument in a command node.
-- Searches for $ characters and expands variables.
-- Updates arguments with expanded values.
-- Handles quotes properly during expansion.
-Returns:
-Nothing (void function).
-Works with process_cmd_token().
-*/
-void	expand_cmd_args(t_node *node, t_vars *vars)
-{
-    int		i;
-    int		j;
-    char	*expanded;
-    char	*result;
-    
-    if (!node || !node->args)
-        return ;
-    i = 0;
-    while (node->args[i])
-    {
-        j = 0;
-        result = ft_strdup("");
-        while (node->args[i][j])
-        {
-            if (node->args[i][j] == '$')
-            {
-                expanded = handle_expansion(node->args[i], &j, vars);
-                if (expanded)
-                {
-                    result = merge_and_free(result, expanded);
-                    ft_safefree((void **)&expanded);
-                }
-            }
-            else
-            {
-                result = append_char(result, node->args[i][j]);
-                j++;
-            }
-        }
-        ft_safefree((void **)&node->args[i]);
-        node->args[i] = result;
-        i++;
-    }
-}
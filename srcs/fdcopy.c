@@ -0,0 +1,205 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   fdcopy.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/23 10:21:48 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/23 10:21:48 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Checks if a failed zero-copy call means "not possible for these fds".
+- Only counts before any data was moved, later failures are real errors.
+Returns:
+1 if the caller should fall back to another copy method.
+0 otherwise.
+Works with copy_range(), copy_splice() and copy_sendfile().
+*/
+int	copy_unsupported(int copied)
+{
+	if (copied)
+		return (0);
+	return (errno == EINVAL || errno == ENOSYS || errno == EXDEV
+		|| errno == EBADF || errno == EOPNOTSUPP);
+}
+
+/*
+Copies file to file with copy_file_range().
+- Data never passes through user space.
+- Filesystems with reflinks may share the blocks instead of copying.
+Returns:
+- 1 when the input reached end of file.
+- 0 if not supported for these files (nothing copied).
+- -1 on error, with errno set.
+Works with copy_fd().
+*/
+int	copy_range(int in, int out)
+{
+	ssize_t	n;
+	int		copied;
+
+	copied = 0;
+	while (1)
+	{
+		n = copy_file_range(in, NULL, out, NULL, COPY_CHUNK, 0);
+		if (n == 0)
+			return (1);
+		if (n > 0)
+			copied = 1;
+		else if (copy_unsupported(copied))
+			return (0);
+		else
+			return (-1);
+	}
+}
+
+/*
+Moves data with splice() when either end is a pipe.
+- Pages are moved between the pipe and the other fd inside the kernel.
+Returns:
+- 1 when the input reached end of file.
+- 0 if not supported for these fds (nothing copied).
+- -1 on error, with errno set.
+Works with copy_fd().
+*/
+int	copy_splice(int in, int out)
+{
+	ssize_t	n;
+	int		copied;
+
+	copied = 0;
+	while (1)
+	{
+		n = splice(in, NULL, out, NULL, COPY_CHUNK,
+				SPLICE_F_MOVE | SPLICE_F_MORE);
+		if (n == 0)
+			return (1);
+		if (n > 0)
+			copied = 1;
+		else if (copy_unsupported(copied))
+			return (0);
+		else
+			return (-1);
+	}
+}
+
+/*
+Copies a regular file to any fd (terminal, socket) with sendfile().
+Returns:
+- 1 when the input reached end of file.
+- 0 if not supported for these fds (nothing copied).
+- -1 on error, with errno set.
+Works with copy_fd().
+*/
+int	copy_sendfile(int in, int out)
+{
+	ssize_t	n;
+	int		copied;
+
+	copied = 0;
+	while (1)
+	{
+		n = sendfile(out, in, NULL, COPY_CHUNK);
+		if (n == 0)
+			return (1);
+		if (n > 0)
+			copied = 1;
+		else if (copy_unsupported(copied))
+			return (0);
+		else
+			return (-1);
+	}
+}
+
+/*
+Copies with a plain read()/write() loop through a large buffer.
+- Used when no zero-copy call supports the pair of fds.
+Returns:
+- 1 when the input reached end of file.
+- -1 on error, with errno set.
+Works with copy_fd().
+*/
+int	copy_rw(int in, int out)
+{
+	char	buf[COPY_BUF_SZ];
+	ssize_t	n;
+	ssize_t	done;
+	ssize_t	ret;
+
+	while (1)
+	{
+		n = read(in, buf, COPY_BUF_SZ);
+		if (n == 0)
+			return (1);
+		if (n < 0)
+			return (-1);
+		done = 0;
+		while (done < n)
+		{
+			ret = write(out, buf + done, n - done);
+			if (ret <= 0)
+				return (-1);
+			done += ret;
+		}
+	}
+}
+
+/*
+Copies everything from one fd to another as cheaply as possible.
+- file -> file: copy_file_range()
+- pipe on either side: splice()
+- file -> anything else: sendfile()
+- Falls back to copy_rw() if the kernel refuses the fast path.
+- Interrupted calls (Ctrl+C) stop the copy.
+Returns:
+0 on success, -1 on error with errno set.
+Works with builtin_cat() and builtin_tee().
+
+Example: For "cat big.log | grep x"
+- in is a regular file, out is a pipe
+- copy_splice() moves the file into the pipe without a user buffer
+*/
+int	copy_fd(int in, int out)
+{
+	struct stat	st_in;
+	struct stat	st_out;
+	int			ret;
+
+	if (fstat(in, &st_in) == -1 || fstat(out, &st_out) == -1)
+		return (-1);
+	ret = 0;
+	if (S_ISREG(st_in.st_mode) && S_ISREG(st_out.st_mode))
+		ret = copy_range(in, out);
+	else if (S_ISFIFO(st_in.st_mode) || S_ISFIFO(st_out.st_mode))
+		ret = copy_splice(in, out);
+	else if (S_ISREG(st_in.st_mode))
+		ret = copy_sendfile(in, out);
+	if (ret == 0)
+		ret = copy_rw(in, out);
+	if (ret == -1)
+		return (-1);
+	return (0);
+}
+
+/*
+Checks if two fds refer to the same regular file.
+- Copying a file onto itself with >> would never reach end of file.
+Returns:
+1 if both are the same regular file, 0 otherwise.
+Works with builtin_cat().
+*/
+int	is_same_file(int in, int out)
+{
+	struct stat	st_in;
+	struct stat	st_out;
+
+	if (fstat(in, &st_in) == -1 || fstat(out, &st_out) == -1)
+		return (0);
+	return (S_ISREG(st_in.st_mode) && st_in.st_dev == st_out.st_dev
+		&& st_in.st_ino == st_out.st_ino);
+}
@@ -0,0 +1,145 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   fdplan.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/22 14:02:41 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/22 14:02:41 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Records one redirection as the next step of a command's fd plan.
+- Output (> and >>) targets stdout, input (< and <<) targets stdin.
+- Files are only described here and opened later in the child.
+- Heredocs are read now, since the child must not prompt the user.
+- target is the file name, or the delimiter for a heredoc.
+Returns:
+- 1 on success.
+- 0 if the plan is full or the heredoc could not be read.
+Works with build_fdplan() and vm_step().
+*/
+int	add_fdop(t_fdplan *plan, t_tokentype type, char *target, t_vars *vars)
+{
+	t_fdop	*op;
+
+	if (plan->count >= FDPLAN_MAX)
+	{
+		ft_putendl_fd("bleshell: too many redirections", 2);
+		return (0);
+	}
+	op = &plan->ops[plan->count];
+	op->target = STDIN_FILENO;
+	op->path = NULL;
+	op->flags = 0;
+	op->fd = -1;
+	if (type == TYPE_OUT_REDIRECT)
+		op->flags = set_redirect_flags(1);
+	else if (type == TYPE_APPEND_REDIRECT)
+		op->flags = set_redirect_flags(2);
+	if (type == TYPE_OUT_REDIRECT || type == TYPE_APPEND_REDIRECT)
+		op->target = STDOUT_FILENO;
+	if (type == TYPE_HEREDOC)
+	{
+		op->fd = open_heredoc(target, vars);
+		if (op->fd == -1)
+			return (0);
+	}
+	else
+		op->path = target;
+	plan->count++;
+	return (1);
+}
+
+/*
+Resolves a chain of redirection nodes into one ordered fd plan.
+- Walks the chain from the outermost node, which is command-line order.
+- Stops at the wrapped command.
+Returns:
+- 1 on success.
+- 0 on failure, with any heredoc descriptors already closed.
+Works with exec_redirect_cmd().
+
+Example: For "cat < in << EOF > out"
+- ops[0] = {stdin, "in", O_RDONLY}
+- ops[1] = {stdin, heredoc pipe fd}
+- ops[2] = {stdout, "out", O_WRONLY | O_CREAT | O_TRUNC}
+*/
+int	build_fdplan(t_node *node, t_fdplan *plan, t_vars *vars)
+{
+	plan->count = 0;
+	while (node && is_redirection(node->type))
+	{
+		if (!node->right || !node->right->args || !node->right->args[0]
+			|| !add_fdop(plan, node->type, node->right->args[0], vars))
+		{
+			close_fdplan(plan);
+			return (0);
+		}
+		node = node->left;
+	}
+	return (1);
+}
+
+/*
+Applies an fd plan inside the child process before execve().
+- Opens each file and moves it onto its target with dup2().
+- Later steps for the same target simply replace earlier ones.
+- Every temporary descriptor is closed once it is in place.
+Returns:
+- 1 if every redirection was applied.
+- 0 on the first failure (error already reported).
+Works with exec_child_cmd().
+*/
+int	apply_fdplan(t_fdplan *plan, t_vars *vars)
+{
+	t_fdop	*op;
+	int		i;
+	int		fd;
+
+	i = 0;
+	while (i < plan->count)
+	{
+		op = &plan->ops[i];
+		fd = op->fd;
+		if (op->path)
+			fd = open(op->path, op->flags | O_CLOEXEC, 0644);
+		if (fd == -1)
+		{
+			redirect_error(op->path, vars, 1);
+			return (0);
+		}
+		if (dup2(fd, op->target) == -1)
+		{
+			close(fd);
+			return (0);
+		}
+		close(fd);
+		op->fd = -1;
+		i++;
+	}
+	return (1);
+}
+
+/*
+Releases descriptors an fd plan opened in the shell.
+- Only heredoc pipes are opened before fork, so only they are closed.
+Works with build_fdplan() and exec_child_cmd().
+*/
+void	close_fdplan(t_fdplan *plan)
+{
+	int	i;
+
+	i = 0;
+	while (i < plan->count)
+	{
+		if (plan->ops[i].fd > 2)
+			close(plan->ops[i].fd);
+		plan->ops[i].fd = -1;
+		i++;
+	}
+}
@@ -0,0 +1,166 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   flatast.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/25 20:14:09 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/25 20:14:09 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Measures an AST for flatten_ast().
+- Adds one node per tree node, one word slot per arg plus one for the
+  node's NULL entry, the word's segments and its text with '\0'.
+Works with flatten_ast().
+*/
+void	flat_measure(t_node *node, t_flatsize *size)
+{
+	int	i;
+
+	if (!node)
+		return ;
+	size->nodes++;
+	size->words++;
+	i = 0;
+	while (node->args && node->args[i])
+	{
+		size->words++;
+		size->segs += count_word_segs(node->args[i]);
+		size->pool += ft_strlen(node->args[i]) + 1;
+		i++;
+	}
+	flat_measure(node->left, size);
+	flat_measure(node->right, size);
+}
+
+/*
+Allocates a flat AST and points its arrays into the block.
+- Pointer-sized arrays come first and the pool last, so every array
+  stays aligned without padding.
+Returns:
+The empty flat AST, or NULL on allocation failure.
+Works with flatten_ast().
+
+Example: 3 nodes, 5 word slots, 4 segments, 20 pool bytes
+- [header][argv x5][words x5][segs x4][type x3][left x3][right x3]
+  [arg_start x3][arg_count x3][pool x20]
+*/
+t_flatast	*flat_alloc(t_flatsize *size)
+{
+	t_flatast	*ast;
+	char		*block;
+
+	block = malloc(sizeof(t_flatast)
+			+ (sizeof(char *) + sizeof(t_word)) * size->words
+			+ sizeof(t_wseg) * size->segs
+			+ (sizeof(t_tokentype) + sizeof(int) * 4) * size->nodes
+			+ size->pool);
+	if (!block)
+		return (NULL);
+	ast = (t_flatast *)block;
+	ast->count = size->nodes;
+	ast->root = -1;
+	ast->argv = (char **)(ast + 1);
+	ast->words = (t_word *)(ast->argv + size->words);
+	ast->segs = (t_wseg *)(ast->words + size->words);
+	ast->type = (t_tokentype *)(ast->segs + size->segs);
+	ast->left = (int *)(ast->type + size->nodes);
+	ast->right = ast->left + size->nodes;
+	ast->arg_start = ast->right + size->nodes;
+	ast->arg_count = ast->arg_start + size->nodes;
+	ast->pool = (char *)(ast->arg_count + size->nodes);
+	return (ast);
+}
+
+/*
+Copies one node's args into the flat AST.
+- Each word's text goes into the pool, argv points at it and its
+  template is split in place, segments following the word array.
+- The node's range ends with a NULL argv entry and an empty template.
+Works with flat_fill().
+*/
+void	flat_copy_args(t_flatast *ast, int i, char **args, t_flatsize *at)
+{
+	size_t	len;
+	int		n;
+
+	ast->arg_start[i] = at->words;
+	n = 0;
+	while (args && args[n])
+	{
+		len = ft_strlen(args[n]) + 1;
+		ast->argv[at->words] = ft_memcpy(ast->pool + at->pool, args[n], len);
+		at->pool += len;
+		ast->words[at->words].segs = ast->segs + at->segs;
+		ast->words[at->words].count = split_word(ast->argv[at->words],
+				ast->segs + at->segs);
+		at->segs += ast->words[at->words].count;
+		at->words++;
+		n++;
+	}
+	ast->arg_count[i] = n;
+	ast->argv[at->words] = NULL;
+	ast->words[at->words].segs = NULL;
+	ast->words[at->words].count = 0;
+	at->words++;
+}
+
+/*
+Copies a tree into the flat AST in command-line order.
+- The left subtree is copied first, then the node, then the right
+  subtree, so the nodes of a pipeline stage sit next to each other.
+Returns:
+Index of the node in the flat AST, -1 for no node.
+Works with flatten_ast().
+
+Example: PIPE(CMD ls, REDIR(CMD wc, STRING out))
+- 0 ls  1 |  2 wc  3 >  4 out
+- left[1] = 0, right[1] = 3, left[3] = 2, right[3] = 4
+*/
+int	flat_fill(t_flatast *ast, t_node *node, t_flatsize *at)
+{
+	int	left;
+	int	i;
+
+	if (!node)
+		return (-1);
+	left = flat_fill(ast, node->left, at);
+	i = at->nodes++;
+	ast->type[i] = node->type;
+	ast->left[i] = left;
+	flat_copy_args(ast, i, node->args, at);
+	ast->right[i] = flat_fill(ast, node->right, at);
+	return (i);
+}
+
+/*
+Flattens an AST into a single block.
+- Two passes: one sizes everything, the second copies. Nothing in
+  the result points back into the tree, so the token list can be
+  freed while the flat AST lives on.
+Returns:
+The flat AST (free() it when done), or NULL if root is NULL or
+allocation failed.
+Works with build_and_execute() and execute_cmd().
+*/
+t_flatast	*flatten_ast(t_node *root)
+{
+	t_flatast	*ast;
+	t_flatsize	size;
+
+	if (!root)
+		return (NULL);
+	ft_memset(&size, 0, sizeof(t_flatsize));
+	flat_measure(root, &size);
+	ast = flat_alloc(&size);
+	if (!ast)
+		return (NULL);
+	ft_memset(&size, 0, sizeof(t_flatsize));
+	ast->root = flat_fill(ast, root, &size);
+	return (ast);
+}
@@ -247,7 +247,7 @@ int	read_heredoc(int *fd, char *delimiter, t_vars *vars, int expand_vars)
 
     while (1)
     {
-        line = readline("> ");
+        line = shell_readline("> ", vars);
         if (!line)
             break ;
         if (ft_strcmp(line, delimiter) == 0)
@@ -306,31 +306,47 @@ Creates a pipe for heredoc redirection.
 Returns:
 File descriptor for reading heredoc content.
 -1 on any error.
-Works with proc_heredoc().
+Works with handle_heredoc() and add_fdop().
 
-Example: Node with delimiter "EOF"
+Example: Delimiter "EOF"
 - Creates pipe
 - Reads input lines until "EOF"
 - Returns read end of pipe for command input
 */
-int	handle_heredoc(t_node *node, t_vars *vars)
+int	open_heredoc(char *delimiter, t_vars *vars)
 {
     int	fd[2];
     int	expand_vars;
     int	read_success;
 
-    if (!node || !node->args || !node->args[0])
-        return (handle_heredoc_err(node, vars));
-    if (pipe(fd) == -1)
-        return (handle_heredoc_err(node, vars));
-    expand_vars = chk_expand_heredoc(node->args[0]);
-    read_success = read_heredoc(fd, node->args[0], vars, expand_vars);
+    if (!delimiter || pipe2(fd, O_CLOEXEC) == -1)
+    {
+        vars->error_code = 1;
+        return (-1);
+    }
+    expand_vars = chk_expand_heredoc(delimiter);
+    read_success = read_heredoc(fd, delimiter, vars, expand_vars);
     if (!read_success)
         return (cleanup_heredoc_fail(fd, vars));
     close(fd[1]);
     return (fd[0]);
 }
 
+/*
+Opens the heredoc of a delimiter node.
+- Validates the node, then reads the heredoc with open_heredoc().
+Returns:
+File descriptor for reading heredoc content.
+-1 on any error.
+Works with proc_heredoc() and open_builtin_redir().
+*/
+int	handle_heredoc(t_node *node, t_vars *vars)
+{
+    if (!node || !node->args || !node->args[0])
+        return (handle_heredoc_err(node, vars));
+    return (open_heredoc(node->args[0], vars));
+}
+
 /*
 Main function for heredoc redirection process.
 - Gets file descriptor with heredoc content.
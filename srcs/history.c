@@ -32,7 +32,7 @@ int	init_history_fd(int mode)
 
     if (access(HISTORY_FILE, F_OK) == -1)
     {
-        fd = open(HISTORY_FILE, O_WRONLY | O_CREAT, 0644);
+        fd = open(HISTORY_FILE, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
         if (fd == -1)
             return (-1);
         close(fd);
@@ -41,7 +41,7 @@ int	init_history_fd(int mode)
         return (-1);
     if (mode == O_WRONLY && access(HISTORY_FILE, W_OK) == -1)
         return (-1);
-    fd = open(HISTORY_FILE, mode);
+    fd = open(HISTORY_FILE, mode | O_CLOEXEC);
     return (fd);
 }
 
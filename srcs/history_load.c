@@ -6,109 +6,199 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/03 12:48:27 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/19 18:51:18 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 18:47:36 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../includes/minishell.h"
 
 /*
-Skips specified number of lines from history file.
-- Reads and discards requested number of lines.
-- Properly frees line memory during skipping.
-- Stops if end of file is reached before count is complete.
+Remembers the history loader for readline's getc hook and for
+save_history(), which take no context pointer.
 Returns:
-Nothing (void function).
-Works with load_history() to maintain history size limits.
+The registered loader (hist is stored if not NULL).
+Works with load_history(), hist_getc() and save_history().
+*/
+t_histload	*hist_state(t_histload *hist)
+{
+    static t_histload	*current;
+
+    if (hist)
+        current = hist;
+    return (current);
+}
+
+/*
+Reads the history file and finds the lines to keep.
+- Runs on the loader thread: only plain syscalls and malloc(), no
+  readline calls and no get_next_line() (which keeps static state).
+- The whole file is read in one go, then scanned backwards for the
+  start of the last HIST_MEM_MAX lines.
+- Newlines become NULs, so hist_merge() can add the lines in place.
+- Leaves text empty if the file is missing or unreadable.
+Works with hist_thread().
 
-Example: If history file has 1000 entries but HIST_MEM_MAX is 500
-- skip_history_lines(fd, 500) skips first 500 entries
-- Allows only loading the 500 most recent commands
+Example: File with 1500 lines, HIST_MEM_MAX=1000
+- start is the offset of line 501
 */
-void	skip_history_lines(int fd, int skip_count)
+void	hist_read(t_histload *hist)
 {
-    char	*line;
+    struct stat	st;
+    ssize_t		n;
+    int			fd;
+    int			lines;
+    int			i;
 
-    while (skip_count > 0)
+    fd = init_history_fd(O_RDONLY);
+    if (fd == -1)
+        return ;
+    if (fstat(fd, &st) == 0 && st.st_size > 0 && st.st_size < INT_MAX)
+        hist->text.data = malloc(st.st_size + 1);
+    n = 1;
+    while (hist->text.data && hist->text.len < st.st_size && n > 0)
     {
-        line = get_next_line(fd);
-        if (!line)
-            break ;
-        ft_safefree((void **)&line);
-        skip_count--;
+        n = read(fd, hist->text.data + hist->text.len,
+                st.st_size - hist->text.len);
+        if (n > 0)
+            hist->text.len += n;
     }
+    close(fd);
+    if (!hist->text.data)
+        return ;
+    hist->text.data[hist->text.len] = '\0';
+    lines = 0;
+    i = hist->text.len - 1;
+    while (--i >= 0 && lines < HIST_MEM_MAX)
+        if (hist->text.data[i] == '\n' && ++lines == HIST_MEM_MAX)
+            hist->start = i + 1;
+    i = hist->start - 1;
+    while (++i < hist->text.len)
+        if (hist->text.data[i] == '\n')
+            hist->text.data[i] = '\0';
 }
 
 /*
-Reads history lines from file descriptor and adds to readline history.
-- Gets lines one by one using get_next_line().
-- Removes trailing newlines from each history entry.
-- Adds non-empty lines to readline's history memory.
-- Properly frees memory for each processed line.
+Loader thread body.
+- Signals efd when done, which wakes the event loop.
 Returns:
-Nothing (void function).
-Works with load_history() after skip_history_lines().
+NULL.
+Works with load_history().
+*/
+void	*hist_thread(void *arg)
+{
+    t_histload	*hist;
+    uint64_t	one;
 
-Example: After skipping excess lines
-- Reads remaining lines like "ls -la", "cd .."
-- Adds each valid entry to readline history
-- Stops at EOF, leaving history populated with latest commands
+    hist = arg;
+    hist_read(hist);
+    one = 1;
+    write(hist->efd, &one, sizeof(one));
+    return (NULL);
+}
+
+/*
+Starts loading the history file off the startup path.
+- The file is read on a thread while the first prompt is shown.
+- The thread's eventfd joins the event loop's epoll set: once it is
+  done, the lines are merged while the prompt waits (hist_merge()).
+- A keystroke that may use history before then waits for the loader
+  (hist_getc()), as does save_history().
+- The thread inherits the shell's blocked signal mask, so it never
+  takes a signal meant for the shell.
+- Without threads or an eventfd the file is read right away.
+Works with init_shell().
+
+Example: History file with 1000 lines
+- Prompt shows at once, the loader finishes a few ms later
+- The first Up arrow sees all 1000 lines
 */
-void	read_history_lines(int fd)
+void	load_history(t_vars *vars)
 {
-    char	*line;
-    size_t	len;
+    t_histload			*hist;
+    struct epoll_event	reg;
 
-    line = get_next_line(fd);
-    while (line)
+    hist = &vars->hist;
+    hist_state(hist);
+    hist->owner = getpid();
+    hist->epfd = -1;
+    hist->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    hist->loading = 1;
+    if (hist->efd == -1 || pthread_create(&hist->thread, NULL,
+            hist_thread, hist) != 0)
     {
-        if (*line)
-        {
-            // Remove trailing newline if present
-            len = ft_strlen(line);
-            if (len > 0 && line[len - 1] == '\n')
-                line[len - 1] = '\0';
-                
-            add_history(line);
-        }
-        ft_safefree((void **)&line);
-        line = get_next_line(fd);
+        hist_read(hist);
+        hist->loading = 0;
+        hist_merge(hist);
+        return ;
     }
+    rl_getc_function = hist_getc;
+    reg.events = EPOLLIN;
+    reg.data.fd = hist->efd;
+    if (vars->events.epfd >= 0 && epoll_ctl(vars->events.epfd,
+            EPOLL_CTL_ADD, hist->efd, &reg) == 0)
+        hist->epfd = vars->events.epfd;
 }
 
 /*
-Loads command history from file into readline's history memory.
-- Counts total history entries to determine if skipping is needed.
-- Skips older entries if count exceeds HIST_MEM_MAX limit.
-- Reads remaining entries into readline history memory.
-- Handles file opening/closing and empty history cases.
-Returns:
-Nothing (void function).
-Works with init_shell() during program startup.
-
-Example: For a shell with HIST_MEM_MAX=1000
-- Checks history file size
-- If 1500 entries exist, skips first 500
-- Loads most recent 1000 entries into memory
-- Returns without action if history is empty or inaccessible
+Adds the loaded lines to readline's history.
+- Waits for the loader thread if it is still reading.
+- Runs before any line of this session is added, so the file's lines
+  come first, as with a synchronous load.
+- The prompt may already be up: using_history() moves readline's
+  history position past the new lines, or Up would start at the oldest.
+- Does nothing once merged, or in a forked child (no loader there).
+Works with event_readline(), hist_getc(), reader() and save_history().
 */
-void	load_history(void)
+void	hist_merge(t_histload *hist)
 {
-    int		fd;
-    int		count;
-    int		skip;
+    char	*line;
 
-    count = get_history_count();
-    if (count == 0)
+    if (!hist || (hist->loading && hist->owner != getpid()))
         return ;
-    fd = init_history_fd(O_RDONLY);
-    if (fd == -1)
-        return ;
-    skip = 0;
-    if (count > HIST_MEM_MAX)
-        skip = count - HIST_MEM_MAX;
-    skip_history_lines(fd, skip);
-    read_history_lines(fd);
-    close(fd);
+    if (hist->loading)
+    {
+        pthread_join(hist->thread, NULL);
+        hist->loading = 0;
+        rl_getc_function = rl_getc;
+    }
+    if (hist->epfd >= 0)
+        epoll_ctl(hist->epfd, EPOLL_CTL_DEL, hist->efd, NULL);
+    if (hist->efd >= 0)
+        close(hist->efd);
+    hist->epfd = -1;
+    hist->efd = -1;
+    line = hist->text.data + hist->start;
+    while (hist->text.data && line < hist->text.data + hist->text.len)
+    {
+        add_history(line);
+        line += ft_strlen(line) + 1;
+    }
+    using_history();
+    ft_safefree((void **)&hist->text.data);
+    hist->text.len = 0;
+    hist->start = 0;
 }
 
+/*
+Readline getc hook while the loader runs.
+- Keys that can reach history are escape sequences (arrows, Meta
+  keys), control keys (Ctrl+P/N/R/S, Enter) and 8-bit Meta bytes:
+  those merge the history first, waiting for the loader if needed.
+- Plain text, Tab and Backspace are passed through without waiting.
+Returns:
+The character read, as rl_getc().
+Works with load_history().
+
+Example: Up arrow 2 ms after the prompt, loader still reading
+- '\e' arrives: waits for the loader, merges
+- "[A" then recalls the last line of the history file
+*/
+int	hist_getc(FILE *stream)
+{
+    int	c;
+
+    c = rl_getc(stream);
+    if (c != EOF && ((c < ' ' && c != '\t' && c != '\b') || c >= 0x80))
+        hist_merge(hist_state(NULL));
+    return (c);
+}
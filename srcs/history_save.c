@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/02 14:35:22 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/20 18:49:59 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 18:47:36 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -62,10 +62,10 @@ int	copy_file(const char *src, const char *dst)
     int		fd_dst;
     int		result;
 
-    fd_src = open(src, O_RDONLY);
+    fd_src = open(src, O_RDONLY | O_CLOEXEC);
     if (fd_src == -1)
         return (0);
-    fd_dst = open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    fd_dst = open(dst, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
     if (fd_dst == -1)
     {
         close(fd_src);
@@ -96,7 +96,8 @@ int	copy_to_temp(int fd_read)
     int		fd_write;
     char	*line;
 
-    fd_write = open(HISTORY_FILE_TMP, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    fd_write = open(HISTORY_FILE_TMP, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+            0644);
     if (fd_write == -1)
         return (0);
     line = get_next_line(fd_read);
@@ -182,6 +183,8 @@ Saves readline history entries to history file.
 - Skips excess entries if count exceeds HISTORY_FILE_MAX.
 - Writes valid entries to history file with newlines.
 - Logs details of the save operation for debugging.
+- The file is rewritten from memory, so a history file still being
+  loaded is merged first.
 Returns:
 Nothing (void function).
 Works with cleanup_exit() during shell termination.
@@ -201,7 +204,7 @@ void	save_history(void)
     int			history_count;
     int			excess_lines;
 
-    fd = open(HISTORY_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    fd = open(HISTORY_FILE, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
     if (fd == -1)
     {
         perror("bleshell: error opening history file");
@@ -229,7 +232,8 @@ void	save_history(void)
     int			start_idx;
     
     fprintf(stderr, "DEBUG: Starting history save\n");
-    fd = open(HISTORY_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    hist_merge(hist_state(NULL));
+    fd = open(HISTORY_FILE, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
     if (fd == -1)
     {
         perror("bleshell: error opening history file");
@@ -22,6 +22,7 @@ Returns 1 on success, 0 on failure.
 int	make_nodeframe(t_node *node, t_tokentype type, char *token)
 {
 	node->type = type;
+	node->words = NULL;
 	node->next = NULL;
 	node->prev = NULL;
 	node->left = NULL;
@@ -6,47 +6,15 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/17 10:03:35 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 03:57:52 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/25 21:02:37 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../includes/minishell.h"
 
-/*
-Check if a command is complete.
-Returns 1 if complete, 0 if more input is needed.
-Complete means no unclosed quotes and no dangling pipes.
-*/
-int	is_input_complete(t_vars *vars)
-{
-	t_node	*current;
-	int		expecting_command;
-	
-	expecting_command = 0;
-	current = vars->head;
-	
-	while (current)
-	{
-		if (current->type == TYPE_PIPE)
-		{
-			expecting_command = 1;
-		}
-		else if (expecting_command && current->type != TYPE_STRING 
-			&& current->type != TYPE_CMD)
-		{
-			expecting_command = 1;
-		}
-		else if (expecting_command)
-		{
-			expecting_command = 0;
-		}
-		current = current->next;
-	}
-	return (!expecting_command);
-}
-
 /*
 Check if there's an unfinished pipe at the end of input.
+- Reads the syntax validator state, the token list is not walked.
 Returns:
 - 1 if there's an unfinished pipe needing completion
 - 0 if there's no unfinished pipe
@@ -54,30 +22,15 @@ Works with handle_unfinished_pipes().
 */
 int	check_unfinished_pipe(t_vars *vars, t_ast *ast)
 {
-	t_node	*last_token;
-	t_node	*current;
-	
-	last_token = NULL;
-	current = vars->head;
-	// Find the last token
-	while (current)
-	{
-		last_token = current;
-		current = current->next;
-	}
-	// Check if the last token is a pipe
-	if (last_token && last_token->type == TYPE_PIPE)
+	if (syntax_status(vars) == SYNTAX_MORE_PIPE)
 	{
-		// If we have an AST struct, update its state
 		if (ast)
 			ast->pipe_at_end = 1;
-		return 1;
+		return (1);
 	}
-	// Also check the AST pipe_at_end flag if already set
 	if (ast && ast->pipe_at_end)
-		return 1;
-	
-	return 0;
+		return (1);
+	return (0);
 }
 
 /*
@@ -112,49 +65,81 @@ int	handle_unfinished_pipes(char **processed_cmd, t_vars *vars, t_ast *ast)
 	return (1);
 }
 */
-int handle_unfinished_pipes(char **processed_cmd, t_vars *vars, t_ast *ast)
+/*
+Reads one line for a command that ended with a pipe.
+- Prompts with "PIPE> " and trims surrounding whitespace.
+- Appends the line to text after a space, empty lines add nothing.
+Returns:
+- 1 on success (including an empty line).
+- -1 on EOF or allocation failure.
+Works with handle_unfinished_pipes().
+*/
+int	read_pipe_line(t_linebuf *text, t_vars *vars)
 {
-    char *addon_input = NULL;
-    char *tmp = NULL;
-    
-    fprintf(stderr, "DEBUG: Checking for unfinished pipe\n");
-    if (!check_unfinished_pipe(vars, ast))
-        return (0);
-    fprintf(stderr, "DEBUG: Found pipe at end, prompting for more input\n");
-    ft_putstr_fd("bleshell: Pipe at end of input\n", 2);
-    addon_input = readline("PIPE> ");
-    if (!addon_input)
+	char	*addon;
+	char	*line;
+	int		added;
+
+	ft_putstr_fd("bleshell: Pipe at end of input\n", 2);
+	addon = shell_readline("PIPE> ", vars);
+	if (!addon)
+		return (-1);
+	line = ft_strtrim(addon, " \t\n");
+	free(addon);
+	if (!line)
+		return (-1);
+	added = 1;
+	if (line[0])
+		added = linebuf_add(text, ' ', line);
+	free(line);
+	if (!added)
+		return (-1);
+	return (1);
+}
+
+/*
+Check for unfinished pipes in input and handle them.
+- Keeps prompting while the last token is a pipe, so "a |" followed
+  by "b |" and "c" builds "a | b | c".
+- processed_cmd grows in place as one buffer and only the new line is
+  lexed, continuing after the tokens already in vars->head.
+- Quotes left open on a new line are completed by lex_open_quotes().
+- A syntax error in the added lines (e.g. "a |" then "| b") is
+  reported and the command is dropped.
+Returns:
+- 1 if pipes were handled and modifications were made
+- 0 if no unfinished pipes found
+- -1 if an error occurred (processed_cmd still holds the text so far)
+*/
+int	handle_unfinished_pipes(char **processed_cmd, t_vars *vars, t_ast *ast)
+{
+	t_linebuf	text;
+	int			result;
+
+	if (!check_unfinished_pipe(vars, ast))
+		return (0);
+	text.data = *processed_cmd;
+	text.len = ft_strlen(text.data);
+	text.cap = text.len + 1;
+	vars->current = vars->head;
+	while (vars->current && vars->current->next)
+		vars->current = vars->current->next;
+	result = 1;
+	while (result > 0 && syntax_status(vars) == SYNTAX_MORE_PIPE)
 	{
-        fprintf(stderr, "DEBUG: EOF at pipe prompt, aborting\n");
-        return -1;
-    }
-    tmp = ft_strtrim(addon_input, " \t\n");
-    free(addon_input); // Free original before reassignment
-    addon_input = tmp;
-    if (!addon_input || addon_input[0] == '\0') {
-        fprintf(stderr, "DEBUG: Empty input, exiting\n");
-        free(addon_input); // Free if empty
-        return handle_unfinished_pipes(processed_cmd, vars, ast); // Try again
-    }
-    fprintf(stderr, "DEBUG: Appending new input: '%s'\n", addon_input);
-    tmp = ft_strjoin(*processed_cmd, " ");
-    if (!tmp) {
-        free(addon_input);
-        return -1;
-    }
-    char *combined = ft_strjoin(tmp, addon_input);
-    free(tmp);         // Free intermediate string
-    free(addon_input); // Free additional input
-    if (!combined)
-        return (-1);
-    free(*processed_cmd);
-    *processed_cmd = combined;
-    fprintf(stderr, "DEBUG: Successfully appended new input\n");
-    fprintf(stderr, "DEBUG: New combined command: '%s'\n", *processed_cmd);
-    cleanup_token_list(vars);
-    tokenize(*processed_cmd, vars);
-    lexerlist(*processed_cmd, vars);
-    return (1);
+		vars->pos = text.len;
+		vars->start = text.len;
+		result = read_pipe_line(&text, vars);
+		if (result > 0)
+			handle_token(text.data, vars);
+		if (result > 0 && vars->quote_depth > 0
+			&& !lex_open_quotes(&text, vars))
+			result = -1;
+	}
+	if (result > 0 && chk_syntax(vars) == SYNTAX_ERROR)
+		result = -1;
+	*processed_cmd = text.data;
+	return (result);
 }
 
 /*
@@ -181,7 +166,7 @@ char	*get_quote_input(t_vars *vars)
 	else
 		prompt = "DQUOTE> ";
 	// Read additional input
-	addon = readline(prompt);
+	addon = shell_readline(prompt, vars);
 	if (!addon)
 	{
 		fprintf(stderr, "DEBUG: Received EOF during quote completion\n");
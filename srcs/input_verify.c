@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/17 10:01:36 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 11:50:36 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/25 21:48:10 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -61,68 +61,6 @@ int process_input_addons(char **processed_cmd, t_vars *vars, t_ast *ast)
 	return (0);
 }
 
-/*
-Check if input starts with a pipe token (syntax error).
-Returns:
-- 1 if pipe found at beginning of input
-- 0 if no pipe at beginning or no tokens
-Works with chk_syntax_errors().
-*/
-int	chk_pipe_before_cmd(t_vars *vars, t_ast *ast)
-{
-    if (!vars || !vars->head)
-        return (0);
-        
-    if (vars->head->type == TYPE_PIPE)
-    {
-        // Update AST state if needed
-        if (ast)
-            ast->pipe_at_front = 1;
-        return (1);
-    }
-    
-    return (0);
-}
-
-/*
-Check for consecutive pipes in token list (syntax error).
-Code 258 is the standard code used for syntax errors.
-Returns:
-0 - no consecutive pipes found
-1 - consecutive pipes found (sets error code)
-*/
-int	chk_serial_pipes(t_vars *vars, t_ast *ast)
-{
-	t_node	*current;
-	
-	if (!vars || !vars->head || !ast)
-		return (0);
-	ast->serial_pipes = 0;
-	current = vars->head;
-	fprintf(stderr, "DEBUG: [chk_serial_pipes] Checking for adjacent pipes\n");
-	while (current)
-	{
-		if (current->type == TYPE_PIPE)
-		{
-			if (ast->serial_pipes > 0)
-			{
-				fprintf(stderr, "DEBUG: [chk_serial_pipes] Found adjacent pipes, setting error code %d\n", 1);
-				fprintf(stderr, "DEBUG: Syntax error: consecutive pipes\n");
-				if (vars->pipeline)
-					vars->pipeline->last_cmdcode = 258;
-				ast->syntax_error = 1;
-				return (1);
-			}
-			ast->serial_pipes++;
-		}
-		else
-			ast->serial_pipes = 0;
-		current = current->next;
-	}
-	fprintf(stderr, "DEBUG: [chk_serial_pipes] Exiting with status %d\n", 1);
-	return (0);
-}
-
 /*
 Check for syntax errors in the input.
 Returns:
@@ -192,50 +130,6 @@ int chk_syntax_errors(t_vars *vars)
     return (0);
 }
 */
-int chk_syntax_errors(t_vars *vars)
-{
-    t_ast *ast;
-    
-    fprintf(stderr, "DEBUG: [chk_syntax_errors] Starting syntax check\n");
-    ast = init_ast_struct();
-    if (!ast)
-        return (1);
-        
-    // Check for pipe at beginning
-    if (chk_pipe_before_cmd(vars, ast))
-    {
-        fprintf(stderr, "DEBUG: in chk_syntax_errors - run chk_pipe_bf_cmd\n");
-        fprintf(stderr, "DEBUG: [chk_syntax_errors] Pipeline state: %p\n", (void*)vars->pipeline);
-        ft_putstr_fd("bleshell: syntax error near unexpected token `|'\n", 2);
-        if (vars->pipeline)
-            vars->pipeline->last_cmdcode = 258;
-        cleanup_ast_struct(ast);
-        
-        // Clean up token list to prevent double free
-        cleanup_token_list(vars);
-        return (1);
-    }
-    
-    // Check for consecutive pipes
-    if (chk_serial_pipes(vars, ast))
-    {
-        fprintf(stderr, "DEBUG: in chk_syntax_errors - run chk_serial_pipes\n");
-        fprintf(stderr, "DEBUG: [chk_syntax_errors] Found error: Adjacent pipes\n");
-        ft_putstr_fd("bleshell: syntax error near unexpected token `|'\n", 2);
-        if (vars->pipeline)
-            vars->pipeline->last_cmdcode = 258;
-        cleanup_ast_struct(ast);
-        
-        // Clean up token list to prevent double free
-        cleanup_token_list(vars);
-        return (1);
-    }
-    
-    cleanup_ast_struct(ast);
-    fprintf(stderr, "DEBUG: [chk_syntax_errors] Exiting with status %d\n", 0);
-    return (0);
-}
-
 /*
 Counts the number of tokens in a token list.
 Used for debugging memory management.DEBUGGING REMOVE LATER
@@ -317,7 +211,7 @@ int prepare_input(char *input, t_vars *vars, char **processed_cmd)
     fprintf(stderr, "DEBUG: [prepare_input] Before syntax check, token count: %d\n",
             count_tokens(vars->head));
             
-    if (chk_syntax_errors(vars))
+    if (chk_syntax(vars) == SYNTAX_ERROR)
     {
         fprintf(stderr, "DEBUG: [prepare_input] Syntax error detected, cleaning up processed_cmd %p\n",
                 (void*)*processed_cmd);
@@ -371,11 +265,12 @@ int prepare_input(char *input, t_vars *vars, char **processed_cmd)
     fprintf(stderr, "DEBUG: [prepare_input] Before syntax check, token count: %d\n",
             count_tokens(vars->head));
             
-    if (chk_syntax_errors(vars))
+    if (chk_syntax(vars) == SYNTAX_ERROR)
     {
         fprintf(stderr, "DEBUG: [prepare_input] Syntax error detected, cleaning up processed_cmd %p\n",
                 (void*)*processed_cmd);
                 
+        cleanup_token_list(vars);
         // Free the processed command string
         ft_safefree((void **)processed_cmd);
         
@@ -413,7 +308,7 @@ int chk_input_valid(t_vars *vars, char **input)
     }
     // Then handle pipes
     t_ast *ast = init_ast_struct();
-    if (ast && !is_input_complete(vars)) {
+    if (ast && syntax_status(vars) == SYNTAX_MORE_PIPE) {
         // Use handle_pipe_valid from minishell.c
         char *result = handle_pipe_valid(*input, vars, 0);
         if (result && result != *input) {
@@ -446,7 +341,8 @@ char	*verify_input(char *input, t_vars *vars)
 	tokenize(complete_input, vars);
 	lexerlist(complete_input, vars);
 	/* Check for unclosed quotes or incomplete pipes */
-	while (vars->quote_depth > 0 || !is_input_complete(vars))
+	while (syntax_status(vars) == SYNTAX_MORE_QUOTE
+		|| syntax_status(vars) == SYNTAX_MORE_PIPE)
 	{
 		modified = chk_input_valid(vars, &complete_input);
 		if (!complete_input)
@@ -0,0 +1,126 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   job_control.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/25 10:14:26 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 19:02:14 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Takes control of the terminal for an interactive shell.
+- Waits until the shell is in the foreground (SIGTTIN otherwise).
+- Puts the shell in its own process group and gives it the terminal.
+- Ignores the terminal stop signals so the shell itself never stops.
+- Saves the terminal modes, restored whenever a job gives the
+  terminal back.
+Works with init_shell(). Only used in TTY mode.
+*/
+void	init_job_control(t_vars *vars)
+{
+	if (!isatty(STDIN_FILENO))
+		return ;
+	while (tcgetpgrp(STDIN_FILENO) != getpgrp())
+		kill(-getpgrp(), SIGTTIN);
+	signal(SIGTSTP, SIG_IGN);
+	signal(SIGTTIN, SIG_IGN);
+	signal(SIGTTOU, SIG_IGN);
+	vars->shell_pgid = getpid();
+	setpgid(0, vars->shell_pgid);
+	tcsetpgrp(STDIN_FILENO, vars->shell_pgid);
+	tcgetattr(STDIN_FILENO, &vars->tmodes);
+	vars->job_control = 1;
+}
+
+/*
+Moves a freshly forked child into the current job's process group.
+- The first child of a command line starts a new group and, for a
+  foreground job, takes the terminal.
+- Later children (other pipeline stages) join that group, so the
+  terminal sends Ctrl+C to the whole pipeline at once.
+- Terminal stop signals the shell ignores are set back to default,
+  so Ctrl+Z stops the job and the shell gets it back with WUNTRACED.
+Called in the child right after fork(). The parent mirrors it with
+track_job_pgrp(), so the group exists whichever side runs first.
+*/
+void	join_job_pgrp(t_vars *vars, int foreground)
+{
+	if (!vars->job_control)
+		return ;
+	if (vars->pgid == 0)
+	{
+		vars->pgid = getpid();
+		setpgid(0, vars->pgid);
+		if (foreground)
+			tcsetpgrp(STDIN_FILENO, vars->pgid);
+	}
+	else
+		setpgid(0, vars->pgid);
+	signal(SIGTSTP, SIG_DFL);
+	signal(SIGTTIN, SIG_DFL);
+	signal(SIGTTOU, SIG_DFL);
+}
+
+/*
+Parent side of join_job_pgrp().
+- Records the group of the first child and hands it the terminal
+  for a foreground job.
+Works with every fork() site that runs part of a command line.
+*/
+void	track_job_pgrp(t_vars *vars, pid_t pid, int foreground)
+{
+	if (!vars->job_control || pid <= 0)
+		return ;
+	if (vars->pgid == 0)
+	{
+		vars->pgid = pid;
+		setpgid(pid, pid);
+		if (foreground)
+			tcsetpgrp(STDIN_FILENO, pid);
+	}
+	else
+		setpgid(pid, vars->pgid);
+}
+
+/*
+Gives the terminal back to the shell after a foreground job, whether
+it finished or was stopped.
+- Restores the shell's process group and saved terminal modes, in
+  case the job left the terminal in raw mode.
+- Clears the job's group so the next command line starts a new one.
+- If the job died from Ctrl+C the shell never saw the SIGINT (it went
+  to the job's group), so the next prompt is moved to a fresh line.
+Works with build_and_execute() and builtin_fg().
+*/
+void	reclaim_terminal(t_vars *vars, int status)
+{
+	vars->pgid = 0;
+	if (!vars->job_control)
+		return ;
+	if (status == 128 + SIGINT)
+		g_signal_received = 1;
+	tcsetpgrp(STDIN_FILENO, vars->shell_pgid);
+	tcsetattr(STDIN_FILENO, TCSADRAIN, &vars->tmodes);
+}
+
+/*
+Sends a signal to a job's whole process group.
+- One killpg() reaches every process of a pipeline, however deeply
+  the shell forked to build it.
+- Without job control the job shares the shell's group, so only the
+  job's own process is signalled.
+Returns:
+0 on success, -1 on failure.
+Works with builtin_fg() and builtin_bg().
+*/
+int	signal_job(t_vars *vars, t_job *job, int sig)
+{
+	if (vars->job_control)
+		return (killpg(job->pid, sig));
+	return (kill(job->pid, sig));
+}
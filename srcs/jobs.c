@@ -0,0 +1,561 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   jobs.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/24 10:12:05 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:48:12 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Finds the lowest free slot of the job table.
+Returns:
+Index of the slot, or -1 if the table is full.
+Works with add_job() and launch_job().
+*/
+int	free_job_slot(t_vars *vars)
+{
+	int	i;
+
+	i = 0;
+	while (i < JOBS_MAX && vars->jobs[i].pid != 0)
+		i++;
+	if (i == JOBS_MAX)
+		return (-1);
+	return (i);
+}
+
+/*
+Adds a background process to the job table.
+- Takes the lowest free slot, so job ids are reused like in bash.
+- Opens a pidfd so the job can be reaped with poll().
+- Without pidfd support the job is reaped with waitpid(WNOHANG).
+Returns:
+The new job id, or -1 if the table is full.
+Works with launch_job().
+
+Example: First job "sleep 5" with pid 4242
+- jobs[0] = {id: 1, pid: 4242, state: JOB_RUNNING, cmd: "sleep 5"}
+- Returns 1
+*/
+int	add_job(t_vars *vars, pid_t pid, char *cmd)
+{
+	t_job	*job;
+	int		i;
+
+	i = free_job_slot(vars);
+	if (i < 0)
+		return (-1);
+	job = &vars->jobs[i];
+	job->id = i + 1;
+	job->pid = pid;
+	job->pidfd = pidfd_open(pid, 0);
+	job->state = JOB_RUNNING;
+	job->status = 0;
+	job->procs = 1;
+	job->last = pid;
+	job->cmd = cmd;
+	vars->job_current = i;
+	return (job->id);
+}
+
+/*
+Makes another job the current one ("+", the default of fg and bg).
+- The stopped job with the highest id wins, then the running or done
+  job with the highest id, close to bash's "most recent" job.
+- With an empty table the index stays on slot 0, which find_job()
+  reports as no job.
+Works with remove_job().
+*/
+void	pick_current_job(t_vars *vars)
+{
+	int	best;
+	int	i;
+
+	best = -1;
+	i = 0;
+	while (i < JOBS_MAX)
+	{
+		if (vars->jobs[i].pid != 0 && (best < 0
+				|| (vars->jobs[i].state == JOB_STOPPED)
+				>= (vars->jobs[best].state == JOB_STOPPED)))
+			best = i;
+		i++;
+	}
+	vars->job_current = 0;
+	if (best >= 0)
+		vars->job_current = best;
+}
+
+/*
+Frees a job table slot.
+- Closes the pidfd and releases the command text.
+- Removing the current job makes another one current, so fg, bg and
+  "%%" keep working after "wait -n" or a "Done" report.
+Works with report_jobs(), builtin_wait() and builtin_fg().
+*/
+void	remove_job(t_vars *vars, t_job *job)
+{
+	if (job->pidfd >= 0)
+		close(job->pidfd);
+	ft_safefree((void **)&job->cmd);
+	ft_memset(job, 0, sizeof(t_job));
+	if (job == &vars->jobs[vars->job_current])
+		pick_current_job(vars);
+}
+
+/*
+Looks up a job from a job specification.
+- NULL, "%", "%%" or "%+": the current (most recent) job.
+- "%N": job number N.
+- "N": the job whose process id is N.
+Returns:
+Pointer to the job, or NULL if there is no such job.
+Works with builtin_wait(), builtin_fg() and builtin_bg().
+*/
+t_job	*find_job(t_vars *vars, const char *spec)
+{
+	int	i;
+	int	id;
+
+	if (!spec || !ft_strcmp(spec, "%") || !ft_strcmp(spec, "%%")
+		|| !ft_strcmp(spec, "%+"))
+	{
+		if (vars->jobs[vars->job_current].pid == 0)
+			return (NULL);
+		return (&vars->jobs[vars->job_current]);
+	}
+	id = ft_atoi(spec + (spec[0] == '%'));
+	i = 0;
+	while (i < JOBS_MAX)
+	{
+		if (vars->jobs[i].pid != 0 && ((spec[0] == '%'
+					&& vars->jobs[i].id == id) || (spec[0] != '%'
+					&& vars->jobs[i].pid == id)))
+			return (&vars->jobs[i]);
+		i++;
+	}
+	return (NULL);
+}
+
+/*
+Records a wait status in a job.
+- Stopped processes become JOB_STOPPED.
+- Exited or killed processes become JOB_DONE with their exit code.
+Returns:
+The shell exit code for the status (128 + signal if killed).
+Works with poll_jobs() and wait_job().
+*/
+int	update_job(t_job *job, int status)
+{
+	if (WIFSTOPPED(status))
+	{
+		job->state = JOB_STOPPED;
+		job->status = 128 + WSTOPSIG(status);
+	}
+	else if (WIFEXITED(status))
+	{
+		job->state = JOB_DONE;
+		job->status = WEXITSTATUS(status);
+	}
+	else if (WIFSIGNALED(status))
+	{
+		job->state = JOB_DONE;
+		job->status = 128 + WTERMSIG(status);
+	}
+	return (job->status);
+}
+
+/*
+Reaps processes of a job.
+- With job control the whole process group is waited on, so every
+  stage of a stopped pipeline is reaped, not only the first.
+- Returns as soon as a process stops. Otherwise the job is done once
+  its last process is gone, with the exit code of its last stage.
+- options are passed to waitpid() (WNOHANG, WUNTRACED).
+Returns:
+1 if the job stopped or finished, 0 if not (yet), -1 on error.
+Works with poll_jobs() and wait_job().
+*/
+int	reap_job(t_vars *vars, t_job *job, int options)
+{
+	pid_t	ret;
+	int		status;
+
+	while (1)
+	{
+		if (vars->job_control)
+			ret = waitpid(-job->pid, &status, options);
+		else
+			ret = waitpid(job->pid, &status, options);
+		if (ret == -1 && errno == ECHILD)
+			job->procs = 0;
+		else if (ret <= 0)
+			return (ret);
+		else if (WIFSTOPPED(status))
+			return (update_job(job, status), 1);
+		else if (ret == job->last || (job->procs == 1 && job->last != 0))
+		{
+			update_job(job, status);
+			job->last = 0;
+		}
+		if (ret > 0)
+			job->procs--;
+		if (job->procs <= 0)
+			return (job->state = JOB_DONE, 1);
+		job->state = JOB_RUNNING;
+	}
+}
+
+/*
+Puts a command line stopped in the foreground (Ctrl+Z) in the job table.
+- The job is the command line's process group; procs of its stages
+  are still to be reaped, last is the one whose exit code counts.
+- Only one process is watched through a pidfd, so a stopped pipeline
+  is reaped with waitpid(WNOHANG) instead.
+- With the table full the job cannot be resumed later: it is
+  continued and waited for as before.
+Returns:
+128 + the stop signal, also stored in vars->error_code, or the
+command line's exit code if the table was full.
+Works with vm_wait() and exec_child_cmd().
+
+Example: "vim notes.txt", then Ctrl+Z
+- Prints "[1]+  Stopped                 vim notes.txt"
+- Returns 148
+*/
+int	stop_job(t_vars *vars, pid_t last, int procs, int status)
+{
+	t_job	job;
+	t_io	io;
+	char	*cmd;
+	int		id;
+
+	cmd = job_cmd_text(vars);
+	id = add_job(vars, vars->pgid, cmd);
+	if (id < 0)
+	{
+		ft_safefree((void **)&cmd);
+		ft_putendl_fd("bleshell: job table full", 2);
+		ft_memset(&job, 0, sizeof(t_job));
+		job.pid = vars->pgid;
+		job.procs = procs;
+		job.last = last;
+		killpg(vars->pgid, SIGCONT);
+		reap_job(vars, &job, 0);
+		return (vars->error_code = job.status);
+	}
+	if (procs > 1 && vars->jobs[id - 1].pidfd >= 0)
+		close(vars->jobs[id - 1].pidfd);
+	if (procs > 1)
+		vars->jobs[id - 1].pidfd = -1;
+	vars->jobs[id - 1].procs = procs;
+	vars->jobs[id - 1].last = last;
+	update_job(&vars->jobs[id - 1], status);
+	init_io(&io, STDIN_FILENO, STDERR_FILENO, STDERR_FILENO);
+	io_write(&io, "\n", 1);
+	print_job(vars, &vars->jobs[id - 1], &io);
+	io_flush(&io);
+	return (vars->error_code = vars->jobs[id - 1].status);
+}
+
+/*
+Collects the pidfds of all running jobs for poll().
+- slot[i] records which table entry pfds[i] belongs to.
+Returns:
+Number of entries filled in.
+Works with poll_jobs().
+*/
+int	collect_job_fds(t_vars *vars, struct pollfd *pfds, int *slot)
+{
+	int	count;
+	int	i;
+
+	count = 0;
+	i = 0;
+	while (i < JOBS_MAX)
+	{
+		if (vars->jobs[i].pid != 0 && vars->jobs[i].state == JOB_RUNNING)
+		{
+			pfds[count].fd = vars->jobs[i].pidfd;
+			pfds[count].events = POLLIN;
+			pfds[count].revents = 0;
+			slot[count++] = i;
+		}
+		i++;
+	}
+	return (count);
+}
+
+/*
+Reaps every running job whose process has exited.
+- Polls the pidfds of all running jobs in one call.
+- Only readable pidfds are waited on, so idle jobs cost nothing.
+- Jobs without a pidfd fall back to waitpid(WNOHANG), and a blocking
+  poll is cut to JOB_POLL_MS so they are still noticed.
+- timeout is passed to poll(): 0 to check, -1 to block for one exit.
+- A blocking poll also watches the signalfd, so Ctrl+C ends it.
+Returns:
+Number of jobs that changed state, -1 if poll() was interrupted.
+Works with report_jobs(), builtin_jobs() and builtin_wait().
+*/
+int	poll_jobs(t_vars *vars, int timeout)
+{
+	struct pollfd	pfds[JOBS_MAX + 1];
+	int				slot[JOBS_MAX];
+	int				count;
+	int				changed;
+
+	count = collect_job_fds(vars, pfds, slot);
+	if (count == 0)
+		return (0);
+	changed = 0;
+	while (changed < count && pfds[changed].fd >= 0)
+		changed++;
+	if (changed < count && timeout < 0)
+		timeout = JOB_POLL_MS;
+	pfds[count].fd = -1;
+	if (timeout != 0)
+		pfds[count].fd = vars->events.sigfd;
+	pfds[count].events = POLLIN;
+	pfds[count].revents = 0;
+	if (poll(pfds, count + 1, timeout) == -1 || (pfds[count].revents
+			&& (read_signals(vars) & (1 << SIGINT))))
+		return (-1);
+	changed = 0;
+	while (count-- > 0)
+	{
+		if ((pfds[count].revents || pfds[count].fd < 0)
+			&& reap_job(vars, &vars->jobs[slot[count]], WNOHANG) > 0)
+			changed++;
+	}
+	return (changed);
+}
+
+/*
+Prints one line of the job table.
+- Format follows bash: "[1]+  Done                    sleep 5".
+Works with report_jobs() and builtin_jobs().
+*/
+void	print_job(t_vars *vars, t_job *job, t_io *io)
+{
+	char	*num;
+	char	*state;
+
+	num = ft_itoa(job->id);
+	io_write(io, "[", 1);
+	io_putstr(io, num);
+	io_write(io, "]", 1);
+	ft_safefree((void **)&num);
+	if (job == &vars->jobs[vars->job_current])
+		io_write(io, "+  ", 3);
+	else
+		io_write(io, "   ", 3);
+	state = "Running                 ";
+	if (job->state == JOB_STOPPED)
+		state = "Stopped                 ";
+	else if (job->state == JOB_DONE && job->status == 0)
+		state = "Done                    ";
+	else if (job->state == JOB_DONE)
+		state = "Exit                    ";
+	io_putstr(io, state);
+	io_putendl(io, job->cmd);
+}
+
+/*
+Reports finished jobs before the next prompt.
+- Reaps without blocking, then prints and frees every finished job.
+- Only used interactively, like bash.
+Works with reader().
+
+Example: "sleep 1 &" finished while the user was typing
+- Prints "[1]+  Done                    sleep 1" above the prompt
+*/
+void	report_jobs(t_vars *vars)
+{
+	t_io	io;
+	int		i;
+
+	poll_jobs(vars, 0);
+	init_io(&io, STDIN_FILENO, STDERR_FILENO, STDERR_FILENO);
+	i = 0;
+	while (i < JOBS_MAX)
+	{
+		if (vars->jobs[i].pid != 0 && vars->jobs[i].state == JOB_DONE)
+		{
+			print_job(vars, &vars->jobs[i], &io);
+			remove_job(vars, &vars->jobs[i]);
+		}
+		i++;
+	}
+	io_flush(&io);
+}
+
+/*
+Appends words to a job's command text, separated by single spaces.
+- text is freed and replaced by the longer copy.
+Returns:
+The new text, or NULL on allocation failure.
+Works with job_cmd_text().
+*/
+char	*append_words(char *text, char **args)
+{
+	char	*tmp;
+	int		i;
+
+	i = 0;
+	while (args && args[i] && text)
+	{
+		tmp = text;
+		if (*text)
+			text = ft_strjoin(text, " ");
+		if (text && text != tmp)
+			free(tmp);
+		tmp = text;
+		if (text)
+			text = ft_strjoin(text, args[i]);
+		free(tmp);
+		i++;
+	}
+	return (text);
+}
+
+/*
+Rebuilds the command line text of the current command.
+- Joins every argument of every node with single spaces.
+- Uses the flat AST when there is one (its nodes are in command-line
+  order), the token list otherwise.
+Returns:
+Newly allocated text for the job table, or NULL on failure.
+Works with launch_job().
+
+Example: Tokens CMD[sleep, 5], '>', STRING[log]
+- Returns "sleep 5 > log"
+*/
+char	*job_cmd_text(t_vars *vars)
+{
+	t_node	*node;
+	char	*text;
+	int		i;
+
+	text = ft_strdup("");
+	if (vars->flat)
+	{
+		i = 0;
+		while (i < vars->flat->count && text)
+			text = append_words(text,
+					&vars->flat->argv[vars->flat->arg_start[i++]]);
+		return (text);
+	}
+	node = vars->head;
+	while (node && text)
+	{
+		text = append_words(text, node->args);
+		node = node->next;
+	}
+	return (text);
+}
+
+/*
+Takes a trailing '&' off the token list.
+- '&' is only accepted as the last token of the line, right after a
+  word. syntax_step() already rejects anything else; this is the
+  last guard before a job is forked.
+- report: 1 to print the syntax error, 0 to only return it (a line
+  parsed ahead of Enter, see spec_build()).
+Returns:
+- 1 if the line ends in '&' (token removed).
+- 0 if there is no '&'.
+- -1 on a misplaced '&' (syntax error set, printed if report).
+Works with build_and_execute() and spec_build().
+*/
+int	detach_bg_token(t_vars *vars, int report)
+{
+	t_node	*node;
+
+	node = vars->head;
+	while (node && node->type != TYPE_BACKGROUND)
+		node = node->next;
+	if (!node)
+		return (0);
+	if (node->next || !node->prev || node->prev->type == TYPE_PIPE
+		|| is_redirection(node->prev->type))
+	{
+		if (report)
+			ft_putendl_fd("bleshell: syntax error near unexpected token `&'",
+				2);
+		vars->error_code = 2;
+		return (-1);
+	}
+	node->prev->next = NULL;
+	if (vars->current == node)
+		vars->current = node->prev;
+	free_token_node(node);
+	return (1);
+}
+
+/*
+Runs the built AST as a background job.
+- Forks a subshell that executes the AST and exits with its status.
+- The subshell's last command is exec()ed in place (no second fork).
+- With job control the job gets its own process group, so Ctrl+C
+  at the prompt only reaches the foreground. Without it the job
+  ignores SIGINT and SIGQUIT instead, like in a non-interactive sh.
+- The shell does not wait: the job is added to the table and reaped
+  later through its pidfd.
+- With the job table full the command is refused before anything
+  is forked.
+Returns:
+0 on success, 1 if fork() failed or the job table is full.
+Works with build_and_execute().
+
+Example: "sleep 5 &"
+- Prints "[1] 4242" (interactive only)
+- Prompt returns at once
+*/
+int	launch_job(t_vars *vars)
+{
+	pid_t	pid;
+	char	*cmd;
+	int		id;
+
+	if (free_job_slot(vars) < 0)
+	{
+		ft_putendl_fd("bleshell: job table full", 2);
+		return (vars->error_code = 1, 1);
+	}
+	pid = fork();
+	if (pid < 0)
+	{
+		perror("bleshell: fork");
+		return (vars->error_code = 1, 1);
+	}
+	if (pid == 0)
+	{
+		vars->pgid = 0;
+		join_job_pgrp(vars, 0);
+		if (!vars->job_control)
+		{
+			signal(SIGINT, SIG_IGN);
+			signal(SIGQUIT, SIG_IGN);
+		}
+		reset_child_signals();
+		vars->subshell = 1;
+		exit(execute_ast(vars));
+	}
+	if (vars->job_control)
+		setpgid(pid, pid);
+	cmd = job_cmd_text(vars);
+	id = add_job(vars, pid, cmd);
+	if (id < 0)
+		ft_safefree((void **)&cmd);
+	if (vars->input.mode == INPUT_TTY)
+		fprintf(stderr, "[%d] %d\n", id, pid);
+	vars->error_code = 0;
+	return (0);
+}
@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/13 15:17:46 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 04:32:49 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 19:41:03 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -71,11 +71,10 @@ void	handle_text_chunk(char *str, t_vars *vars)
 
     if (vars->pos <= vars->start)
         return ;
-    cmd_str = ft_substr(str, vars->start, vars->pos - vars->start);
+    cmd_str = ft_strndup(str + vars->start, vars->pos - vars->start);
     if (!cmd_str)
         return ;
     vars->curr_type = TYPE_CMD;
-    fprintf(stderr, "DEBUG: Processing text chunk: '%s'\n", cmd_str);
     process_cmd_token(cmd_str, vars);
     ft_safefree((void **)&cmd_str);
 }
@@ -207,8 +206,8 @@ void process_text(char *str, t_vars *vars, int *first_token, t_tokentype overrid
         }
         
         if (!balanced) {
-            vars->quote_depth = 1;
-            vars->quote_ctx[0].type = quote_char;
+            vars->quote_depth = 0;
+            push_quote(vars, quote_char);
         }
     }
     maketoken(token, vars);
@@ -277,29 +276,23 @@ void process_text(char *str, t_vars *vars, int *first_token, t_tokentype overrid
     int len;
     
     len = vars->pos - vars->start;
-    token = ft_substr(str, vars->start, len);
+    token = ft_strndup(str + vars->start, len);
     if (!token)
         return;
         
-    fprintf(stderr, "DEBUG: process_text: len=%d, text='%s', first_token=%d\n", 
-            len, token, *first_token);
-            
     // Process as command if it's the first token after a pipe
     if (override_type != TYPE_NULL)
     {
         vars->curr_type = override_type;
-        fprintf(stderr, "DEBUG: Using override type %d\n", override_type);
     }
     else if (*first_token || vars->prev_type == TYPE_PIPE)
     {
         vars->curr_type = TYPE_CMD;
         *first_token = 0;  // Reset first token flag
-        fprintf(stderr, "DEBUG: Classifying as command (after pipe)\n");
     }
     else
     {
         vars->curr_type = TYPE_STRING;
-        fprintf(stderr, "DEBUG: Classifying as STRING\n");
     }
     
     maketoken(token, vars);
@@ -448,79 +441,51 @@ char	*lexing_unclosed_quo(char *input, t_vars *vars)
     return (processed_cmd);
 }
 */
-char *lexing_unclosed_quo(char *input, t_vars *vars)
+/*
+Reads continuation lines until the open quote is closed, lexing only
+what is new instead of re-lexing the whole command line.
+- The lexer state (tokens so far, pos, quote stack, first_token) stays
+  in vars between lines and the text grows in place in one buffer.
+- vars->start marks the opening quote: the pending token, which is not
+  emitted while the quote is open.
+- Each new line is only scanned for the closing quote. Once found,
+  lexing resumes at the opening quote, earlier tokens are kept as is.
+Returns:
+- 1 once every quote is closed.
+- 0 on EOF or allocation failure (quote_depth stays above 0).
+Works with lexerlist() and handle_unfinished_pipes().
+
+Example: "echo 'a", then "b", then "c' tail"
+- "echo" is lexed once, text grows to "echo 'a\nb\nc' tail"
+- Only "b" and "c' tail" are scanned for the closing quote
+- Lexing resumes at 'a and adds "'a\nb\nc'" and "tail"
+*/
+int	lex_open_quotes(t_linebuf *text, t_vars *vars)
 {
-    char *processed_cmd;
-    char *addon;
-    char *temp;
-    int attempts;
-    
-    /* Initialize variables */
-    attempts = 0;
-    processed_cmd = input;
-    
-    /* Process quotes until they're all closed or max attempts reached */
-    while (vars->quote_depth > 0 && attempts < 10)
+    char	*addon;
+    char	quote;
+    int		added;
+
+    while (vars->quote_depth > 0)
     {
-        /* Count this attempt */
-        attempts++;
-        
-        /* Get additional input */
+        quote = vars->quote_ctx[vars->quote_depth - 1].type;
         addon = get_quote_input(vars);
-        fprintf(stderr, "DEBUG: get_quo_put fr lex_uncl_quo\n");
-        
-        /* Check for EOF or error */
         if (!addon)
-            return (NULL);
-            
-        fprintf(stderr, "DEBUG: get_quo_put fr lex_uncl_quo.before calling appnd\n");
-        
-        /* Join strings properly without losing characters */
-        temp = append_input(processed_cmd, addon);
-        
-        /* Free addon right after using it */
+            return (0);
+        vars->pos = text->len;
+        added = linebuf_add(text, '\n', addon);
         ft_safefree((void **)&addon);
-        
-        /* Check if append was successful */
-        if (!temp)
-            return (NULL);
-            
-        /* Update processed_cmd and free old one if needed */
-        if (processed_cmd != input)
-            ft_safefree((void **)&processed_cmd);
-        processed_cmd = temp;
-        
-        fprintf(stderr, "DEBUG: get_quo_put fr lex_uncl_quo.after calling appnd\n");
-        
-        /* Reset parser state completely before retokenizing */
-        cleanup_token_list(vars);
-        vars->quote_depth = 0;  /* Reset quote depth before reprocessing */
-        vars->head = NULL;
-        vars->current = NULL;
-        
-        /* Debug output for the string being tokenized */
-        fprintf(stderr, "DEBUG: Tokenizing combined string: '%s'\n", processed_cmd);
-        
-        /* CRITICAL FIX: Use lexerlist instead of tokenize - this ensures proper command structure */
-        lexerlist(processed_cmd, vars);
-        
-        fprintf(stderr, "DEBUG: After tokenizing with added quote, depth=%d\n", 
-                vars->quote_depth);
-                
-        /* If quotes are now balanced, exit the loop */
-        if (vars->quote_depth == 0)
-            break;
-    }
-    
-    /* Handle too many unclosed quotes */
-    if (vars->quote_depth > 0 && attempts >= 10)
-    {
-        fprintf(stderr, "DEBUG: Failed to close quotes after multiple attempts\n");
-        print_error("Too many unclosed quotes, aborting input", NULL, 0);
+        if (!added)
+            return (0);
+        while (text->data[vars->pos] && text->data[vars->pos] != quote)
+            vars->pos++;
+        if (!text->data[vars->pos])
+            continue ;
+        vars->quote_depth = 0;
+        vars->pos = vars->start;
+        handle_token(text->data, vars);
     }
-    
-    /* Return processed command string */
-    return (processed_cmd);
+    return (1);
 }
 
 /*
@@ -596,12 +561,10 @@ void	create_operator_token(t_vars *vars, t_tokentype type, char *symbol)
         return ;
     vars->curr_type = type;
     build_token_linklist(vars, operator_node);
-    fprintf(stderr, "DEBUG: Added %s operator token\n", 
-        get_token_str(type));
 }
 
 /*
-Processes operator tokens like pipe and redirections.
+Processes operator tokens like pipe, redirections and '&'.
 - Handles single and double character operators.
 - Updates position and token list appropriately.
 Returns:
@@ -644,7 +607,6 @@ void	handle_operator_token(char *str, t_vars *vars, int *first_token)
     if (str[vars->pos] == '|')
     {
         create_operator_token(vars, TYPE_PIPE, "|");
-        fprintf(stderr, "DEBUG: Created pipe operator token with type=%d\n", TYPE_PIPE);
     }
     else if (str[vars->pos] == '>' && str[vars->pos + 1] == '>')
     {
@@ -660,6 +622,8 @@ void	handle_operator_token(char *str, t_vars *vars, int *first_token)
         create_operator_token(vars, TYPE_OUT_REDIRECT, ">");
     else if (str[vars->pos] == '<')
         create_operator_token(vars, TYPE_IN_REDIRECT, "<");
+    else if (str[vars->pos] == '&')
+        create_operator_token(vars, TYPE_BACKGROUND, "&");
         
     vars->pos++;
     vars->start = vars->pos;
@@ -669,9 +633,12 @@ void	handle_operator_token(char *str, t_vars *vars, int *first_token)
 Processes a single token in the input string.
 - Handles different token types: operators, quotes, expansions.
 - Updates position and token list as tokens are processed.
+- Continues from vars->pos and vars->first_token, so lexing can be
+  resumed on a grown buffer.
+- A word left inside an open quote is not emitted yet.
 Returns:
 Nothing (void function).
-Works with lexerlist().
+Works with lexerlist() and lex_open_quotes().
 
 Example: For input "echo $HOME"
 - Processes "echo" as command token
@@ -679,37 +646,56 @@ Example: For input "echo $HOME"
 */
 void	handle_token(char *str, t_vars *vars)
 {
-    int	first_token;
-    
-    first_token = 1;
     while (str && str[vars->pos])
     {
         if (str[vars->pos] == ' ' || str[vars->pos] == '\t' 
             || str[vars->pos] == '\n')
-            handle_token_boundary(str, vars, &first_token);
+            handle_token_boundary(str, vars, &vars->first_token);
         else if (vars->quote_depth == 0 && (str[vars->pos] == '|' 
-            || str[vars->pos] == '>' || str[vars->pos] == '<'))
-            handle_operator_token(str, vars, &first_token);
+            || str[vars->pos] == '>' || str[vars->pos] == '<'
+            || str[vars->pos] == '&'))
+            handle_operator_token(str, vars, &vars->first_token);
         else if ((str[vars->pos] == '\'' || str[vars->pos] == '"') 
             && vars->quote_depth == 0)
-            handle_quote_content(str, vars, &first_token);
+            handle_quote_content(str, vars, &vars->first_token);
         else if (str[vars->pos] == '$' && vars->quote_depth == 0)
-            handle_expansion_token(str, vars, &first_token);
+            handle_expansion_token(str, vars, &vars->first_token);
         else
             vars->pos++;
     }
-    if (vars->pos > vars->start)
-        process_text(str, vars, &first_token, 0);
+    if (vars->pos > vars->start && vars->quote_depth == 0)
+        process_text(str, vars, &vars->first_token, 0);
 }
 
 
 
 
+/*
+Lexes one line without asking for more input.
+- Initializes lexer state and processes all tokens.
+- A quote left open stays open (vars->quote_depth > 0).
+Returns:
+Nothing (void function).
+Works with lexerlist() and spec_build().
+*/
+void	lex_line(char *str, t_vars *vars)
+{
+    vars->pos = 0;
+    vars->start = 0;
+    vars->head = NULL;
+    vars->current = NULL;
+    vars->quote_depth = 0;
+    vars->first_token = 1;
+    syntax_reset(vars);
+    if (str && *str)
+        handle_token(str, vars);
+}
+
 /*
 Main lexical analysis function.
 - Converts input string into linked list of tokens.
-- Initializes lexer state and processes all tokens.
-- Handles special cases like unclosed quotes.
+- Lexes the line with lex_line().
+- Unclosed quotes are completed through lex_open_quotes().
 Returns:
 Nothing (void function).
 Works with verify_input() and other high-level functions.
@@ -720,20 +706,20 @@ Example: Input "echo hello | grep world"
 */
 void	lexerlist(char *str, t_vars *vars)
 {
-    vars->pos = 0;
-    vars->start = 0;
-    vars->head = NULL;
-    vars->current = NULL;
-    
+    t_linebuf	text;
+
     fprintf(stderr, "DEBUG: Starting lexer list for: '%s'\n", str);
-    
+    lex_line(str, vars);
     if (!str || !*str)
         return ;
     
-    handle_token(str, vars);
-    
-    if (vars->quote_depth > 0 && str)
-        str = lexing_unclosed_quo(str, vars);
+    if (vars->quote_depth > 0)
+    {
+        ft_memset(&text, 0, sizeof(t_linebuf));
+        if (linebuf_add(&text, 0, str))
+            lex_open_quotes(&text, vars);
+        ft_safefree((void **)&text.data);
+    }
     
     if (vars->head)
         fprintf(stderr, "DEBUG: Tokens created, first: %s\n", 
@@ -6,17 +6,51 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/03 11:31:02 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 12:06:35 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 20:14:51 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../includes/minishell.h"
 
+/*
+Prints how long the shell took to show its first prompt, when
+STARTUP_STATS_VAR is set.
+- Measured from the start of main(), just before the prompt is drawn.
+Works with reader().
+
+Example: BLESHELL_STARTUP_STATS=1 ./minishell
+- "bleshell: first prompt after 850 us"
+*/
+void	startup_report(t_vars *vars)
+{
+    struct timespec	now;
+    char			*val;
+    long			us;
+
+    val = get_env_val(STARTUP_STATS_VAR, vars->env);
+    if (!val || !*val)
+    {
+        free(val);
+        return ;
+    }
+    free(val);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    us = (now.tv_sec - vars->started.tv_sec) * 1000000L
+        + (now.tv_nsec - vars->started.tv_nsec) / 1000;
+    ft_putstr_fd("bleshell: first prompt after ", 2);
+    ft_putnbr_fd((int)us, 2);
+    ft_putendl_fd(" us", 2);
+}
+
 /*
 Reads input line from the user with prompt display.
 - Displays the shell prompt and awaits user input.
+- In batch mode reads the next line with no prompt and no history.
 - Handles Ctrl+D (EOF) by calling builtin_exit.
 - Adds non-empty lines to command history.
+- Reports finished background jobs before the prompt.
+- Lets the event loop parse the line while it is typed.
+- Merges the loaded history file first, so its lines stay oldest.
 Returns:
 - User input as an allocated string.
 - Never returns on EOF (exits program).
@@ -30,30 +64,43 @@ Example: When user types "ls -la"
 char	*reader(t_vars *vars)
 {
     char	*line;
+    t_io	io;
 
-    line = readline(PROMPT);
+    if (vars->input.mode == INPUT_TTY)
+        report_jobs(vars);
+    if (vars->input.mode == INPUT_TTY && vars->input.lines == 0)
+        startup_report(vars);
+    vars->events.speculate = 1;
+    line = shell_readline(PROMPT, vars);
+    vars->events.speculate = 0;
     if (!line)
-        builtin_exit(vars);
-    if (*line)
+    {
+        init_io(&io, STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO);
+        builtin_exit(NULL, vars, &io);
+    }
+    if (*line && vars->input.mode == INPUT_TTY)
+    {
+        hist_merge(&vars->hist);
         add_history(line);
+    }
     return (line);
 }
 
 /*
 Sets up environment variables for the shell.
-- Duplicates environment array from envp.
+- Imports the environment array from envp (entries are borrowed).
 - Handles memory allocation errors.
 - Initializes environment-dependent shell variables.
 Works with init_shell().
 
 Example: When shell starts
-- Copies environment variables from system
+- Takes over environment variables from system
 - Sets up SHLVL variable for shell nesting level
 - Reports errors if environment setup fails
 */
 void	setup_env(t_vars *vars, char **envp)
 {
-    vars->env = dup_env(envp);
+    vars->env = import_env(envp);
     if (!vars->env)
     {
         ft_putstr_fd("bleshell: error: Failed to duplicate environment\n", 2);
@@ -105,6 +152,8 @@ Initializes the shell environment and variables.
 - Sets up signal handlers.
 - Initializes environment variables.
 - Sets up shell history.
+- Installs tab completion for interactive use.
+- Starts loading shell history in the background.
 - Prepares the command prompt.
 Works with main() as program entry point.
 */
@@ -112,7 +161,7 @@ void init_shell(t_vars *vars, char **envp)
 {
     int result;
     
-    vars->env = dup_env(envp);
+    vars->env = import_env(envp);
     if (!vars->env)
     {
         fprintf(stderr, "ERROR: Failed to duplicate environment variables\n");
@@ -136,10 +185,15 @@ void init_shell(t_vars *vars, char **envp)
     }
     
     // Use load_signals instead of setup_signals
-    load_signals();
+    load_signals(vars);
     
     // Load history instead of calling init_history
-    load_history();
+    if (vars->input.mode == INPUT_TTY)
+    {
+        init_job_control(vars);
+        init_completion(vars);
+        load_history(vars);
+    }
 }
 
 /*
@@ -196,7 +250,7 @@ char	*handle_pipe_valid(char *cmd, t_vars *vars, int syntax_chk)
     char	*new_cmd;
 	char	*pipe_cmd;
 
-    if (syntax_chk != 2)
+    if (syntax_chk != SYNTAX_MORE_PIPE)
 	{
         return (cmd);
 	}
@@ -216,10 +270,33 @@ char	*handle_pipe_valid(char *cmd, t_vars *vars, int syntax_chk)
     return (cmd);
 }
 
+/*
+Runs a built AST in the foreground or as a background job.
+- Takes the terminal back once a foreground command is done.
+- The pipe size setting is read again for each command line.
+Works with build_and_execute() and run_cached_cmd().
+*/
+void	run_ast(t_vars *vars, int background)
+{
+    vars->pipe_size = -1;
+    if (background)
+        launch_job(vars);
+    else
+    {
+        execute_ast(vars);
+        reclaim_terminal(vars, vars->error_code);
+    }
+}
+
 /*
 Builds and executes the command's abstract syntax tree.
 - Creates AST from tokenized input.
 - Executes the command if AST built successfully.
+- A trailing '&' runs the AST as a background job instead.
+- The AST is flattened once into vars->flat (one block, words split
+  into expansion templates), which is what actually runs.
+- If line is given, the flat AST is kept in the parse cache so the
+  same line is not parsed again.
 - Provides debug information about the process.
 Returns:
 Nothing (void function).
@@ -230,8 +307,13 @@ Example: For "echo hello | grep h"
 - Echo command on left branch, grep on right
 - Executes the pipeline with proper redirection
 */
-void	build_and_execute(t_vars *vars)
+void	build_and_execute(t_vars *vars, char *line)
 {
+    int	background;
+
+    background = detach_bg_token(vars, 1);
+    if (background < 0)
+        return ;
     vars->astroot = build_ast(vars);
     if (vars->astroot)
     {
@@ -239,7 +321,11 @@ void	build_and_execute(t_vars *vars)
         if (vars->astroot->args && vars->astroot->args[0])
             fprintf(stderr, "DEBUG: Root command: %s\n", 
                 vars->astroot->args[0]);
-        execute_cmd(vars->astroot, vars->env, vars);
+        vars->flat = flatten_ast(vars->astroot);
+        if (line && vars->flat)
+            pcache_store(line, background, vars);
+        run_ast(vars, background);
+        pcache_release(vars);
     }
     else
         fprintf(stderr, "DEBUG: Failed to build AST\n");
@@ -335,10 +421,10 @@ char *process_pipe_syntax(char *command, char *orig_cmd, t_vars *vars)
     fprintf(stderr, "DEBUG: [process_pipe_syntax] Starting with command=%p, orig_cmd=%p\n", 
             (void*)command, (void*)orig_cmd);
     processed_cmd = command;
-    syntax_chk = chk_pipe_syntax_err(vars);
+    syntax_chk = chk_syntax(vars);
     fprintf(stderr, "DEBUG: [process_pipe_syntax] Syntax check result: %d\n", syntax_chk);
     
-    if (syntax_chk == 1)
+    if (syntax_chk == SYNTAX_ERROR)
     {
         fprintf(stderr, "DEBUG: [process_pipe_syntax] Syntax error detected\n");
         
@@ -388,6 +474,8 @@ Returns:
 Works with main() in command processing loop.
 
 Example: When user types a complex command
+- Runs it straight from the parse cache if it was seen before
+- Only lines parsed without continuation input are cached
 - Processes tokens and handles unclosed quotes
 - Validates and completes pipe syntax if needed
 - Builds and executes command if valid
@@ -396,15 +484,29 @@ Example: When user types a complex command
 int	process_command(char *command, t_vars *vars)
 {
     char	*processed_cmd;
+    char	*line;
+    long	lines;
     
-    processed_cmd = process_input_tokens(command, vars);
-    if (!processed_cmd)
+    if (run_cached_cmd(command, vars))
         return (1);
-    processed_cmd = process_pipe_syntax(processed_cmd, command, vars);
+    lines = vars->input.lines;
+    line = NULL;
+    if (pcache_cacheable(command))
+        line = ft_strdup(command);
+    processed_cmd = process_input_tokens(command, vars);
+    if (processed_cmd)
+        processed_cmd = process_pipe_syntax(processed_cmd, command, vars);
     if (!processed_cmd)
+    {
+        ft_safefree((void **)&line);
         return (1);
+    }
     debug_print_token_list(vars);
-    build_and_execute(vars);
+    if (line && (vars->input.lines != lines
+            || ft_strcmp(processed_cmd, line) != 0))
+        ft_safefree((void **)&line);
+    build_and_execute(vars, line);
+    ft_safefree((void **)&line);
     if (processed_cmd != command)
         ft_safefree((void **)&processed_cmd);
     // ft_safefree((void **)&command);
@@ -456,9 +558,9 @@ int	main(int argc, char **argv, char **envp)
     t_vars	vars;
     char	*input;
     
-    (void)argc;
-    (void)argv;
 	ft_memset(&vars, 0, sizeof(t_vars));
+    clock_gettime(CLOCK_MONOTONIC, &vars.started);
+    setup_input(&vars, argc, argv);
     init_shell(&vars, envp);
     while (1)
     {
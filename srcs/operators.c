@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/01 21:13:52 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 07:06:47 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 19:41:03 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -134,7 +134,7 @@ int handle_single_operator(char *input, int i, t_vars *vars)
     vars->curr_type = get_operator_type(input[i]);
     
     // Create a substring for the operator character
-    token = ft_substr(input, i, 1);
+    token = ft_strndup(input + i, 1);
     if (!token)
         return (i); // Return early if allocation failed
         
@@ -143,9 +143,6 @@ int handle_single_operator(char *input, int i, t_vars *vars)
     
     // Token is freed inside maketoken
     
-    fprintf(stderr, "DEBUG: Operator '%c' detected and tokenized as type %d\n", 
-            input[i], vars->curr_type);
-    
     vars->start = i + 1;
     return (i + 1);
 }
@@ -169,9 +166,6 @@ int	handle_double_operator(char *input, int i, t_vars *vars)
 {
     char	*token;
     
-    fprintf(stderr, "DEBUG: handle_double_operator at pos %d with chars '%c%c'\n", 
-            i, input[i], input[i + 1]);
-            
     // Handle text before the operator if any
     if (i > vars->start)
     {
@@ -179,7 +173,7 @@ int	handle_double_operator(char *input, int i, t_vars *vars)
         vars->start = i;
     }
     
-    token = ft_substr(input, i, 2);
+    token = ft_strndup(input + i, 2);
     if (!token)
         return (i);
         
@@ -191,9 +185,6 @@ int	handle_double_operator(char *input, int i, t_vars *vars)
     else
         vars->curr_type = TYPE_STRING;
         
-    fprintf(stderr, "DEBUG: Double operator '%s' classified as type %d\n", 
-            token, vars->curr_type);
-            
     maketoken(token, vars);
     ft_safefree((void **)&token);
     
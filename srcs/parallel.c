@@ -0,0 +1,279 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   parallel.c                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/24 14:05:37 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/24 14:05:37 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Builds the argument vector for one parallel job.
+- Every "{}" inside a template word is replaced by the item.
+- If no word contains "{}", the item is appended as the last argument.
+Returns:
+Newly allocated argument array, or NULL on allocation failure.
+Works with par_spawn().
+
+Example: Template {"gzip", "-k", "{}"} with item "a.log"
+- Returns {"gzip", "-k", "a.log", NULL}
+Template {"echo"} with item "x"
+- Returns {"echo", "x", NULL}
+*/
+char	**par_build_argv(char **tmpl, char *item)
+{
+	char	**argv;
+	int		count;
+	int		used;
+	int		i;
+
+	count = ft_arrlen(tmpl);
+	argv = ft_calloc(count + 2, sizeof(char *));
+	if (!argv)
+		return (NULL);
+	used = 0;
+	i = -1;
+	while (++i < count)
+	{
+		if (ft_strnstr(tmpl[i], "{}", ft_strlen(tmpl[i])))
+			used = 1;
+		argv[i] = par_subst(tmpl[i], item);
+		if (!argv[i])
+		{
+			ft_free_2d(argv, i);
+			return (NULL);
+		}
+	}
+	if (!used)
+	{
+		argv[count] = ft_strdup(item);
+		if (!argv[count])
+		{
+			ft_free_2d(argv, count);
+			return (NULL);
+		}
+	}
+	return (argv);
+}
+
+/*
+Replaces every "{}" in a template word with the item.
+Returns:
+Newly allocated word, or NULL on allocation failure.
+Works with par_build_argv().
+
+Example: par_subst("{}.bak", "notes")
+- Returns "notes.bak"
+*/
+char	*par_subst(char *word, char *item)
+{
+	char	*hit;
+	char	*res;
+	char	*tmp;
+
+	res = ft_strdup("");
+	hit = ft_strnstr(word, "{}", ft_strlen(word));
+	while (res && hit)
+	{
+		*hit = '\0';
+		tmp = res;
+		res = ft_strjoin(tmp, word);
+		free(tmp);
+		*hit = '{';
+		tmp = res;
+		if (res)
+			res = ft_strjoin(tmp, item);
+		free(tmp);
+		word = hit + 2;
+		hit = ft_strnstr(word, "{}", ft_strlen(word));
+	}
+	tmp = res;
+	if (res)
+		res = ft_strjoin(tmp, word);
+	free(tmp);
+	return (res);
+}
+
+/*
+Starts one job of a parallel run in a free slot.
+- Builds the job's arguments from the template and the item.
+Returns:
+0 on success, -1 if the arguments, pipe or fork failed.
+Works with builtin_parallel().
+*/
+int	par_spawn(t_parallel *par, t_pslot *slot, char *item, t_vars *vars)
+{
+	char	**argv;
+	int		ret;
+
+	argv = par_build_argv(par->tmpl, item);
+	if (!argv)
+		return (-1);
+	ret = par_launch(par, slot, argv, vars);
+	ft_free_2d(argv, ft_arrlen(argv));
+	return (ret);
+}
+
+/*
+Runs one argument vector as a job in the given slot.
+- The job's stdout is a pipe, so its output can be held back until the
+  job ends and written out in one piece.
+- External commands are exec()ed straight from the fork, using the
+  path resolved once for the whole run.
+- Builtin templates run inside the fork with the pipe as their output.
+- argv is only read, the caller keeps ownership.
+Returns:
+0 on success, -1 if the pipe or fork failed.
+Works with par_spawn() and builtin_xargs().
+*/
+int	par_launch(t_parallel *par, t_pslot *slot, char **argv, t_vars *vars)
+{
+	int		fd[2];
+	int		status;
+	t_io	io;
+
+	if (pipe2(fd, O_CLOEXEC) == -1)
+		return (-1);
+	slot->pid = fork();
+	if (slot->pid == 0)
+	{
+		reset_child_signals();
+		dup2(fd[1], STDOUT_FILENO);
+		if (par->builtin)
+		{
+			init_io(&io, STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO);
+			status = par->builtin->fn(argv, vars, &io);
+			io_flush(&io);
+			exit(status);
+		}
+		execve(par->path, argv, vars->env);
+		perror("bleshell");
+		exit(126);
+	}
+	close(fd[1]);
+	if (slot->pid < 0)
+	{
+		close(fd[0]);
+		slot->pid = 0;
+		return (-1);
+	}
+	slot->fd = fd[0];
+	slot->len = 0;
+	par->running++;
+	return (0);
+}
+
+/*
+Finishes a job whose output pipe reached end of file.
+- Reaps the process and counts it as failed if it exited non-zero.
+- Writes the whole buffered output in one go, so lines from
+  different jobs never interleave.
+Works with par_drain().
+*/
+void	par_finish(t_parallel *par, t_pslot *slot, t_io *io)
+{
+	int	status;
+
+	close(slot->fd);
+	slot->fd = -1;
+	while (waitpid(slot->pid, &status, 0) == -1 && errno == EINTR)
+		;
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		par->failed++;
+	io_write_direct(io, slot->buf, slot->len);
+	slot->pid = 0;
+	slot->len = 0;
+	par->running--;
+}
+
+/*
+Reads from the output pipes of the running jobs.
+- Sleeps in poll() until at least one pipe has data or closes.
+- Buffers grow as needed, so a job never blocks on a full pipe.
+- Finished jobs are reaped and their output written out.
+Returns:
+0 on success, 1 on allocation failure (message printed).
+Works with builtin_parallel().
+*/
+int	par_drain(t_parallel *par, t_io *io)
+{
+	struct pollfd	pfds[PAR_JOBS_MAX];
+	int				i;
+	ssize_t			ret;
+
+	i = -1;
+	while (++i < par->jobs)
+	{
+		pfds[i].fd = par->slots[i].fd;
+		if (par->slots[i].pid == 0)
+			pfds[i].fd = -1;
+		pfds[i].events = POLLIN;
+	}
+	if (poll(pfds, par->jobs, -1) == -1)
+		return (0);
+	i = -1;
+	while (++i < par->jobs)
+	{
+		if (pfds[i].fd < 0 || !pfds[i].revents)
+			continue ;
+		if (par_reserve(&par->slots[i]) == -1)
+			return (copy_error("parallel", "output", strerror(errno), io));
+		ret = read(pfds[i].fd, par->slots[i].buf + par->slots[i].len,
+				par->slots[i].cap - par->slots[i].len);
+		if (ret > 0)
+			par->slots[i].len += ret;
+		else if (ret == 0 || errno != EINTR)
+			par_finish(par, &par->slots[i], io);
+	}
+	return (0);
+}
+
+/*
+Makes sure a slot's output buffer has room for another read.
+- Starts at PAR_BUF_SZ and doubles when full.
+Returns:
+0 on success, -1 on allocation failure.
+Works with par_drain().
+*/
+int	par_reserve(t_pslot *slot)
+{
+	char	*grown;
+	size_t	cap;
+
+	if (slot->len < slot->cap)
+		return (0);
+	cap = slot->cap * 2;
+	if (cap == 0)
+		cap = PAR_BUF_SZ;
+	grown = malloc(cap);
+	if (!grown)
+		return (-1);
+	if (slot->len)
+		ft_memcpy(grown, slot->buf, slot->len);
+	free(slot->buf);
+	slot->buf = grown;
+	slot->cap = cap;
+	return (0);
+}
+
+/*
+Finds a job slot that has no running process.
+Returns:
+Index of the first free slot (builtin_parallel() only asks while
+fewer than par->jobs jobs are running, so one always exists).
+Works with builtin_parallel().
+*/
+int	par_free_slot(t_parallel *par)
+{
+	int	i;
+
+	i = 0;
+	while (i < par->jobs - 1 && par->slots[i].pid != 0)
+		i++;
+	return (i);
+}
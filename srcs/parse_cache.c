@@ -0,0 +1,231 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   parse_cache.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/25 16:05:31 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:08:19 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Hashes an input line with 64-bit FNV-1a.
+Returns:
+Hash of the line.
+Works with run_cached_cmd() and pcache_store().
+*/
+unsigned long	pcache_hash(const char *line)
+{
+	unsigned long	hash;
+
+	hash = 14695981039346656037UL;
+	while (*line)
+	{
+		hash ^= (unsigned char)*line++;
+		hash *= 1099511628211UL;
+	}
+	return (hash);
+}
+
+/*
+Checks if a line's parse may be reused.
+- The tokenizer substitutes some variables while lexing, so a line
+  with '$' would freeze their values into the cached tokens.
+Returns:
+1 if the line can be cached, 0 otherwise.
+Works with process_command().
+*/
+int	pcache_cacheable(char *line)
+{
+	return (line && *line && !ft_strchr(line, '$'));
+}
+
+/*
+Looks up a line in the parse cache.
+- The hash picks candidates, the text confirms the match.
+Returns:
+Matching entry, or NULL.
+Works with run_cached_cmd().
+*/
+t_pcentry	*pcache_find(t_pcache *cache, char *line, unsigned long hash)
+{
+	int	i;
+
+	i = 0;
+	while (i < PCACHE_SLOTS)
+	{
+		if (cache->slots[i].line && cache->slots[i].hash == hash
+			&& ft_strcmp(cache->slots[i].line, line) == 0)
+			return (&cache->slots[i]);
+		i++;
+	}
+	return (NULL);
+}
+
+/*
+Frees one cache entry and the flat AST it owns.
+- The whole parsed command is a single block, so this is one free().
+Works with pcache_slot().
+*/
+void	pcache_free_entry(t_pcentry *entry)
+{
+	ft_safefree((void **)&entry->ast);
+	ft_safefree((void **)&entry->line);
+}
+
+/*
+Picks the slot for a new entry.
+- A free slot if there is one, else the least recently used entry,
+  which is evicted.
+Returns:
+The emptied slot.
+Works with pcache_store().
+*/
+t_pcentry	*pcache_slot(t_pcache *cache)
+{
+	t_pcentry	*victim;
+	int			i;
+
+	victim = &cache->slots[0];
+	i = 0;
+	while (i < PCACHE_SLOTS)
+	{
+		if (!cache->slots[i].line)
+			return (&cache->slots[i]);
+		if (cache->slots[i].stamp < victim->stamp)
+			victim = &cache->slots[i];
+		i++;
+	}
+	pcache_free_entry(victim);
+	return (victim);
+}
+
+/*
+Moves the freshly built flat AST into the cache.
+- vars->flat keeps pointing at it for this run; pcache_release()
+  hands it back to the cache afterwards. The token list stays with
+  the shell and is freed as usual.
+- Nothing is cached if the line cannot be copied, or if the AST
+  cannot be compiled (a hit could not run it without the tree).
+Works with build_and_execute().
+*/
+void	pcache_store(char *line, int background, t_vars *vars)
+{
+	t_pcentry	*entry;
+	t_program	*prog;
+	char		*copy;
+
+	prog = compile_ast(vars->flat);
+	if (!prog)
+		return ;
+	free_program(prog);
+	copy = ft_strdup(line);
+	if (!copy)
+		return ;
+	entry = pcache_slot(&vars->pcache);
+	entry->hash = pcache_hash(line);
+	entry->line = copy;
+	entry->ast = vars->flat;
+	entry->background = background;
+	entry->stamp = ++vars->pcache.clock;
+	vars->pcache.active = 1;
+}
+
+/*
+Lets go of the flat AST once its command line has run.
+- A cached AST is only detached, the cache still owns it.
+- Any other flat AST is freed.
+Works with build_and_execute() and run_cached_cmd().
+*/
+void	pcache_release(t_vars *vars)
+{
+	if (!vars->pcache.active)
+		free(vars->flat);
+	vars->flat = NULL;
+	vars->pcache.active = 0;
+}
+
+/*
+Runs a line straight from the parse cache.
+- A hit skips tokenize(), lexerlist(), the syntax checks,
+  build_ast() and flatten_ast(): the cached flat AST is executed as
+  is. Execution never modifies it, so it stays valid for the next hit.
+- A line parsed while it was typed (spec_parse()) is a hit too.
+Returns:
+1 if the line was found and run, 0 on a miss.
+Works with process_command().
+
+Example: A script running "ls -l | wc -l" in a loop
+- First time: miss, parsed and stored
+- Every later time: hit, executed without lexing
+*/
+int	run_cached_cmd(char *line, t_vars *vars)
+{
+	t_pcentry		*entry;
+	unsigned long	hash;
+
+	if (!pcache_cacheable(line))
+		return (0);
+	hash = pcache_hash(line);
+	entry = pcache_find(&vars->pcache, line, hash);
+	if (!entry)
+		entry = spec_take(&vars->pcache, line, hash);
+	if (!entry)
+	{
+		vars->pcache.misses++;
+		return (0);
+	}
+	vars->pcache.hits++;
+	cleanup_token_list(vars);
+	entry->stamp = ++vars->pcache.clock;
+	vars->flat = entry->ast;
+	vars->pcache.active = 1;
+	run_ast(vars, entry->background);
+	pcache_release(vars);
+	return (1);
+}
+
+/*
+Prints the parse cache hit rate when PCACHE_STATS_VAR is set.
+- Lines the cache refuses (containing '$') are not counted.
+Works with cleanup_exit() and builtin_exit().
+
+Example: BLESHELL_PCACHE_STATS=1 ./minishell < script
+- "bleshell: parse cache: 998 hits, 2 misses (99%)"
+- Interactive shells add ", N parsed while typing" when there were any
+*/
+void	pcache_report(t_vars *vars)
+{
+	char	*val;
+	int		total;
+
+	val = get_env_val(PCACHE_STATS_VAR, vars->env);
+	if (!val || !*val)
+	{
+		free(val);
+		return ;
+	}
+	free(val);
+	total = vars->pcache.hits + vars->pcache.misses;
+	ft_putstr_fd("bleshell: parse cache: ", 2);
+	ft_putnbr_fd(vars->pcache.hits, 2);
+	ft_putstr_fd(" hits, ", 2);
+	ft_putnbr_fd(vars->pcache.misses, 2);
+	ft_putstr_fd(" misses (", 2);
+	if (total)
+		ft_putnbr_fd((int)((long)vars->pcache.hits * 100 / total), 2);
+	else
+		ft_putnbr_fd(0, 2);
+	ft_putstr_fd("%)", 2);
+	if (vars->pcache.spec_hits)
+	{
+		ft_putstr_fd(", ", 2);
+		ft_putnbr_fd(vars->pcache.spec_hits, 2);
+		ft_putstr_fd(" parsed while typing", 2);
+	}
+	ft_putchar_fd('\n', 2);
+}
@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/01 22:23:30 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/19 23:39:14 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 17:21:03 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -115,7 +115,8 @@ char	*search_in_env(char *cmd, char **envp)
 /*
 Resolves command path for execution.
 - Handles absolute and relative paths directly.
-- Searches PATH environment for other commands.
+- Looks other commands up in the PATH command table (cmdtab_find()),
+  then searches PATH environment directories if it is not there.
 - Verifies executable permissions.
 Returns:
 Full path to executable or NULL if not found/accessible.
@@ -123,12 +124,14 @@ Works with execute_cmd() during command execution.
 
 Example: For "ls" command
 - Checks if it's a direct path (starts with / or ./)
-- If not, searches in PATH environment directories
+- If not, finds it in the command table of PATH
 - Returns "/bin/ls" (or similar) if found
 - Returns NULL with error message if not found
 */
-char	*get_cmd_path(char *cmd, char **envp)
+char	*get_cmd_path(char *cmd, char **envp, t_vars *vars)
 {
+    char	*path;
+
     if (cmd[0] == '/' || (cmd[0] == '.' && (cmd[1] == '/'
         || (cmd[1] == '.' && cmd[2] == '/'))))
     {
@@ -138,44 +141,96 @@ char	*get_cmd_path(char *cmd, char **envp)
         ft_putendl_fd(cmd, 2);
         return (NULL);
     }
+    path = cmdtab_find(cmd, envp, vars);
+    if (path)
+        return (path);
     return (search_in_env(cmd, envp));
 }
 
 /*
-Creates a deep copy of environment variables array.
-- Allocates memory for the new array.
-- Duplicates each environment string.
-- Handles memory allocation failures.
+Tells whether an environment entry is still the inherited string.
+- Called once with envp at startup to record where the inherited
+  strings are. The kernel places them back to back, so a single
+  address range covers them all.
+- Inherited strings are borrowed, not copied: they must never be
+  freed (free_env_entry()).
+Returns:
+1 if entry is one of the inherited strings, 0 otherwise (always 0
+when recording).
+Works with import_env() and free_env_entry().
+*/
+int	env_borrowed(char **envp, const char *entry)
+{
+    static uintptr_t	lo;
+    static uintptr_t	hi;
+    size_t				i;
+
+    if (!envp)
+        return ((uintptr_t)entry >= lo && (uintptr_t)entry < hi);
+    i = 0;
+    while (envp[i])
+    {
+        if (!lo || (uintptr_t)envp[i] < lo)
+            lo = (uintptr_t)envp[i];
+        if ((uintptr_t)envp[i] >= hi)
+            hi = (uintptr_t)envp[i] + ft_strlen(envp[i]) + 1;
+        i++;
+    }
+    return (0);
+}
+
+/*
+Builds the shell's environment array on top of the inherited one.
+- Only the pointer array is allocated: the entries are the inherited
+  strings themselves, copied only when a variable is set or unset
+  (copy on write, see free_env_entry()).
+- One slot is spare, so get_shell_level() can add SHLVL if missing.
 Returns:
-Newly allocated copy of environment or NULL on failure.
-Works with init_shell() and builtin environment commands.
+Newly allocated environment array or NULL on failure.
+Works with init_shell().
 
-Example: When executing a command with custom environment
-- Duplicates all environment variables safely
-- Provides independent environment array for modification
-- Ensures memory safety with proper cleanup on errors
+Example: Starting with 20000 inherited variables
+- One malloc() of 20002 pointers, no string copies
+- "export A=1" adds a new string, the others stay borrowed
 */
-char	**dup_env(char **envp)
+char	**import_env(char **envp)
 {
     char	**env;
     size_t	env_size;
-    size_t	i;
 
     env_size = ft_arrlen(envp);
-    env = (char **)malloc(sizeof(char *) * (env_size + 1));
+    env = (char **)malloc(sizeof(char *) * (env_size + 2));
     if (!env)
         return (NULL);
-    i = 0;
-    while (i < env_size)
-    {
-        env[i] = ft_strdup(envp[i]);
-        if (!env[i])
-        {
-            ft_free_2d(env, i);
-            return (NULL);
-        }
-        i++;
-    }
+    env_borrowed(envp, NULL);
+    ft_memcpy(env, envp, sizeof(char *) * env_size);
     env[env_size] = NULL;
     return (env);
 }
+
+/*
+Frees an environment entry that is being replaced or removed.
+- Inherited entries are left alone (env_borrowed()).
+Works with update_shlvl_env(), set_next_pos() and free_env().
+*/
+void	free_env_entry(char *entry)
+{
+    if (entry && !env_borrowed(NULL, entry))
+        free(entry);
+}
+
+/*
+Frees an environment array and the entries the shell allocated.
+Works with cleanup_vars().
+*/
+void	free_env(char **env)
+{
+    size_t	i;
+
+    if (!env)
+        return ;
+    i = 0;
+    while (env[i])
+        free_env_entry(env[i++]);
+    free(env);
+}
@@ -0,0 +1,126 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   pipe_size.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/22 16:37:09 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 20:14:51 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Reads the system limit for pipe buffers.
+- Value comes from /proc/sys/fs/pipe-max-size.
+- Read once and cached in vars, later calls are free.
+- Falls back to PIPE_SIZE_DEFAULT_MAX if the file is unreadable.
+Returns:
+Largest size in bytes an unprivileged process may request.
+Works with get_pipe_size().
+*/
+int	get_pipe_max_size(t_vars *vars)
+{
+	char	buf[32];
+	int		fd;
+	ssize_t	len;
+
+	if (vars->pipe_max_size > 0)
+		return (vars->pipe_max_size);
+	vars->pipe_max_size = PIPE_SIZE_DEFAULT_MAX;
+	fd = open(PIPE_MAX_SIZE_FILE, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return (vars->pipe_max_size);
+	len = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (len > 0)
+	{
+		buf[len] = '\0';
+		if (ft_atoi(buf) > 0)
+			vars->pipe_max_size = ft_atoi(buf);
+	}
+	return (vars->pipe_max_size);
+}
+
+/*
+Parses a pipe size setting.
+- Accepts a byte count with an optional k/K or m/M suffix.
+Returns:
+Size in bytes, or 0 if the string is not a valid size.
+Works with get_pipe_size().
+
+Example: parse_pipe_size("1M")
+- Returns 1048576
+*/
+long	parse_pipe_size(const char *str)
+{
+	long	size;
+	int		i;
+
+	size = 0;
+	i = 0;
+	while (str[i] >= '0' && str[i] <= '9' && size <= INT_MAX)
+		size = size * 10 + (str[i++] - '0');
+	if (i == 0)
+		return (0);
+	if (str[i] == 'k' || str[i] == 'K')
+		size *= 1024;
+	else if (str[i] == 'm' || str[i] == 'M')
+		size *= 1024 * 1024;
+	else if (str[i] != '\0')
+		return (0);
+	if (str[i] != '\0' && str[i + 1] != '\0')
+		return (0);
+	return (size);
+}
+
+/*
+Gets the requested pipeline pipe size.
+- Setting comes from the BLESHELL_PIPE_SIZE variable.
+- Capped at the system limit from get_pipe_max_size().
+- Read once per command line and kept in vars->pipe_size; run_ast()
+  sets it back to -1 before the next line runs.
+Returns:
+Size in bytes, or 0 to keep the kernel default.
+Works with set_pipe_size().
+
+Example: BLESHELL_PIPE_SIZE=4M with pipe-max-size 1048576
+- Returns 1048576
+*/
+int	get_pipe_size(t_vars *vars)
+{
+	char	*val;
+	long	size;
+
+	if (vars->pipe_size >= 0)
+		return (vars->pipe_size);
+	vars->pipe_size = 0;
+	val = get_env_val(PIPE_SIZE_VAR, vars->env);
+	if (!val)
+		return (0);
+	size = parse_pipe_size(val);
+	free(val);
+	if (size > get_pipe_max_size(vars))
+		size = get_pipe_max_size(vars);
+	vars->pipe_size = (int)size;
+	return (vars->pipe_size);
+}
+
+/*
+Resizes a freshly created pipeline pipe.
+- Applies F_SETPIPE_SZ when a pipe size is configured.
+- Failure is silent and not fatal, the pipe keeps its default
+  capacity.
+Works with setup_pipe().
+*/
+void	set_pipe_size(int *pipefd, t_vars *vars)
+{
+	int	size;
+
+	size = get_pipe_size(vars);
+	if (size <= 0)
+		return ;
+	fcntl(pipefd[1], F_SETPIPE_SZ, size);
+}
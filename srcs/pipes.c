@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/17 09:52:41 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 05:06:12 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/25 21:48:10 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -97,6 +97,7 @@ int validate_pipe_node(t_node *pipe_node)
 /*
 Creates and sets up pipe for command communication.
 - Initializes pipe file descriptors.
+- Resizes the pipe if BLESHELL_PIPE_SIZE is set.
 - Handles pipe creation errors.
 Returns:
 1 on success, 0 on failure.
@@ -107,13 +108,14 @@ Example: Before forking processes
 - Reports errors if pipe creation fails
 - Returns success/failure status
 */
-int	setup_pipe(int *pipefd)
+int	setup_pipe(int *pipefd, t_vars *vars)
 {
-    if (pipe(pipefd) == -1)
+    if (pipe2(pipefd, O_CLOEXEC) == -1)
     {
         ft_putendl_fd("pipe: Creation failed", 2);
         return (0);
     }
+    set_pipe_size(pipefd, vars);
     return (1);
 }
 
@@ -232,6 +234,8 @@ pid_t	make_child_proc(t_node *pipe_node, int *pipefd,
     pid = fork();
     if (pid == 0)
     {
+        join_job_pgrp(vars, 1);
+        reset_child_signals();
         if (is_left)
             exec_left_cmd(pipe_node, pipefd, vars);
         else
@@ -239,6 +243,7 @@ pid_t	make_child_proc(t_node *pipe_node, int *pipefd,
     }
     else if (pid < 0)
         ft_putendl_fd("fork: Creation failed", 2);
+    track_job_pgrp(vars, pid, 1);
     return (pid);
 }
 
@@ -310,7 +315,7 @@ char *handle_pipe_completion(char *cmd, t_vars *vars, int syntax_chk)
     t_ast   *ast;
     int     prep_status;
     
-    if (!syntax_chk || is_input_complete(vars))
+    if (syntax_chk != SYNTAX_MORE_PIPE)
         return (ft_strdup(cmd));
     prep_status = prep_pipe_complete(cmd, &result, &pipe_cmd, &ast);
     if (prep_status < 0)
@@ -347,7 +352,7 @@ int	setup_pipeline_procs(t_node *pipe_node, t_vars *vars,
 
 	if (!validate_pipe_node(pipe_node))
 		return (1);
-	if (!setup_pipe(pipefd))
+	if (!setup_pipe(pipefd, vars))
 		return (1);
 	*left_pid = make_child_proc(pipe_node, pipefd, vars, 1);
 	if (*left_pid < 0)
@@ -369,6 +374,34 @@ int	setup_pipeline_procs(t_node *pipe_node, t_vars *vars,
 	return (0);
 }
 
+/*
+Runs the last stage of a pipeline inside the current process.
+- Closes both pipe ends, the stage does not read stdin.
+- Executes the builtin (and any output redirections) without a fork.
+- Waits for the left side so no zombie is left behind.
+Returns:
+Exit status of the builtin stage.
+Works with execute_pipeline() when is_parent_builtin_stage() agrees.
+
+Example: For "cat file | echo done"
+- "cat file" runs in a child writing to the pipe
+- Pipe is closed in the shell, so cat gets SIGPIPE if it keeps writing
+- "echo done" runs directly in the shell
+*/
+int	exec_parent_stage(t_node *pipe_node, int *pipefd, pid_t left_pid,
+		t_vars *vars)
+{
+	int	result;
+	int	status;
+
+	close(pipefd[0]);
+	close(pipefd[1]);
+	result = execute_cmd(pipe_node->right, vars->env, vars);
+	waitpid(left_pid, &status, 0);
+	vars->error_code = result;
+	return (result);
+}
+
 /*
 Executes commands connected by a pipe.
 - Sets up and launches pipeline child processes.
@@ -411,7 +444,7 @@ int execute_pipeline(t_node *pipe_node, t_vars *vars)
         return 1;
     }
     
-    if (!setup_pipe(pipefd)) {
+    if (!setup_pipe(pipefd, vars)) {
         fprintf(stderr, "DEBUG: Failed to create pipe\n");
         return 1;
     }
@@ -427,6 +460,8 @@ int execute_pipeline(t_node *pipe_node, t_vars *vars)
     }
     
     if (pid1 == 0) {
+        join_job_pgrp(vars, 1);
+        reset_child_signals();
         // Child process for left command
         fprintf(stderr, "DEBUG: Child process 1 (PID=%d) executing left command\n", getpid());
         exec_left_cmd(pipe_node, pipefd, vars);
@@ -435,6 +470,9 @@ int execute_pipeline(t_node *pipe_node, t_vars *vars)
     }
     
     // Parent process continues
+    track_job_pgrp(vars, pid1, 1);
+    if (is_parent_builtin_stage(pipe_node->right))
+        return (exec_parent_stage(pipe_node, pipefd, pid1, vars));
     pid2 = fork();
     if (pid2 < 0) {
         fprintf(stderr, "DEBUG: Fork failed for right command\n");
@@ -444,6 +482,8 @@ int execute_pipeline(t_node *pipe_node, t_vars *vars)
     }
     
     if (pid2 == 0) {
+        join_job_pgrp(vars, 1);
+        reset_child_signals();
         // Child process for right command
         fprintf(stderr, "DEBUG: Child process 2 (PID=%d) executing right command\n", getpid());
         exec_right_cmd(pipe_node, pipefd, vars);
@@ -451,6 +491,7 @@ int execute_pipeline(t_node *pipe_node, t_vars *vars)
         exit(1);
     }
     
+    track_job_pgrp(vars, pid2, 1);
     // Parent closes both pipe ends
     fprintf(stderr, "DEBUG: Parent process closing pipe fds\n");
     close(pipefd[0]);
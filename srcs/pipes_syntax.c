@@ -6,8 +6,119 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/17 10:04:44 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/19 22:20:49 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 20:48:12 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../includes/minishell.h"
+
+/*
+Starts a fresh validation for a new token list.
+Works with lexerlist().
+*/
+void	syntax_reset(t_vars *vars)
+{
+	vars->syntax.state = SYN_EMPTY;
+	vars->syntax.error = 0;
+	vars->syntax.error_pos = 0;
+}
+
+/*
+Advances the syntax state machine by one token.
+- Called as each token is linked into the list, so validating a command
+  line costs one step per token and no extra walk over the list.
+- A pipe first, or a pipe right after a pipe, is an error.
+- '&' must follow a word (not a pipe or a redirection operator) and
+  end the line.
+- The error and its offset in the line (vars->pos) are recorded once,
+  later tokens only move the state along.
+Works with build_token_linklist().
+
+Example: "ls | | wc"
+- ls: SYN_EMPTY -> SYN_WORD
+- |: SYN_WORD -> SYN_PIPE
+- |: SYN_PIPE -> SYN_PIPE, error SYN_ERR_PIPES at offset 5
+For "echo a | &"
+- &: SYN_PIPE -> SYN_BACKGROUND, error SYN_ERR_BG at offset 10
+*/
+void	syntax_step(t_vars *vars, t_tokentype type)
+{
+	int	error;
+
+	error = 0;
+	if (type == TYPE_PIPE && vars->syntax.state == SYN_EMPTY)
+		error = SYN_ERR_START;
+	else if (type == TYPE_PIPE && vars->syntax.state == SYN_PIPE)
+		error = SYN_ERR_PIPES;
+	else if (vars->syntax.state == SYN_BACKGROUND
+		|| (type == TYPE_BACKGROUND && vars->syntax.state != SYN_WORD))
+		error = SYN_ERR_BG;
+	if (error && !vars->syntax.error)
+	{
+		vars->syntax.error = error;
+		vars->syntax.error_pos = vars->pos;
+	}
+	if (type == TYPE_PIPE)
+		vars->syntax.state = SYN_PIPE;
+	else if (type == TYPE_BACKGROUND)
+		vars->syntax.state = SYN_BACKGROUND;
+	else if (is_redirection(type))
+		vars->syntax.state = SYN_REDIR;
+	else
+		vars->syntax.state = SYN_WORD;
+}
+
+/*
+Reads the verdict for the current token list without printing anything.
+Returns:
+- SYNTAX_ERROR if a syntax error was recorded.
+- SYNTAX_MORE_QUOTE if a quote is still open.
+- SYNTAX_MORE_PIPE if the last token is a pipe.
+- SYNTAX_COMPLETE otherwise (also for an empty list).
+Works with chk_syntax() and handle_unfinished_pipes().
+*/
+int	syntax_status(t_vars *vars)
+{
+	if (!vars->head)
+		return (SYNTAX_COMPLETE);
+	if (vars->syntax.error)
+		return (SYNTAX_ERROR);
+	if (vars->quote_depth > 0)
+		return (SYNTAX_MORE_QUOTE);
+	if (vars->syntax.state == SYN_PIPE)
+		return (SYNTAX_MORE_PIPE);
+	return (SYNTAX_COMPLETE);
+}
+
+/*
+Checks the current token list and reports a syntax error if there is one.
+- Prints the message for the recorded error and sets error code 258.
+- Incomplete input is not an error, callers prompt for more instead.
+Returns:
+- The syntax_status() verdict.
+Works with process_pipe_syntax() and handle_unfinished_pipes().
+
+Example: For input "| ls"
+- Prints "unexpected syntax error at '|'", returns SYNTAX_ERROR
+For input "echo a > &"
+- Prints "syntax error near unexpected token `&'", returns SYNTAX_ERROR
+For input "ls | grep a |"
+- Prints nothing, returns SYNTAX_MORE_PIPE
+*/
+int	chk_syntax(t_vars *vars)
+{
+	int	status;
+
+	status = syntax_status(vars);
+	if (status != SYNTAX_ERROR)
+		return (status);
+	if (vars->syntax.error == SYN_ERR_START)
+		ft_putstr_fd("bleshell: unexpected syntax error at '|'\n", 2);
+	else if (vars->syntax.error == SYN_ERR_BG)
+		ft_putstr_fd("bleshell: syntax error near unexpected token `&'\n",
+			2);
+	else
+		ft_putstr_fd("bleshell: syntax error near unexpected token '|'\n", 2);
+	vars->error_code = 258;
+	return (status);
+}
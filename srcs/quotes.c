@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/01 21:04:06 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 04:10:00 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 19:41:03 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -105,14 +105,10 @@ void handle_quotes(char *str, int *pos, t_vars *vars)
         /* We have a complete quoted token */
         vars->start = start;
         
-        fprintf(stderr, "DEBUG: Found matched quote: '%.*s'\n", 
-                *pos - start, str + start);
-                
         /* CRITICAL FIX: Check if we have a command node to attach this to */
         if (vars->current && vars->current->type == TYPE_CMD)
         {
             /* Process as a string argument to the command */
-            fprintf(stderr, "DEBUG: Adding quoted string as argument to command\n");
             vars->curr_type = TYPE_STRING;
         }
         else
@@ -128,16 +124,13 @@ void handle_quotes(char *str, int *pos, t_vars *vars)
         vars->quote_depth = 0;
         
         /* Process the quoted token */
-        maketoken(ft_substr(str, start, *pos - start), vars);
+        maketoken(ft_strndup(str + start, *pos - start), vars);
         vars->start = *pos;
     }
     else
     {
         /* Quote is unclosed */
-        vars->quote_depth++;
-        vars->quote_ctx[vars->quote_depth - 1].type = quote_char;
-        fprintf(stderr, "DEBUG: Unclosed %s quote detected (depth: %d)\n",
-                (quote_char == '"' ? "double" : "single"), vars->quote_depth);
+        push_quote(vars, quote_char);
     }
 }
 
@@ -169,7 +162,7 @@ char	*fix_open_quotes(char *input, t_vars *vars)
         prompt = "SQUOTE> ";
     while (vars->quote_depth > 0)
     {
-        line = readline(prompt);
+        line = shell_readline(prompt, vars);
         if (!line)
             return (NULL);
         result = append_input(input, line);
@@ -188,6 +181,8 @@ Extracts content between quote characters.
 - Reads until matching closing quote or end of string.
 - Creates substring without quote characters.
 - Updates position past the closing quote.
+- Stops at once if pos is already at the end of the string (left
+  there by handle_quotes() for an unclosed quote).
 Returns:
 - Quoted content as new string.
 - NULL if unclosed quote.
@@ -202,13 +197,15 @@ char	*read_quoted_content(char *input, int *pos, char quote)
     int		start;
     char	*content;
 
+    if (!input[*pos])
+        return (NULL);
     start = *pos + 1;
     *pos = start;
     while (input[*pos] && input[*pos] != quote)
         (*pos)++;
     if (!input[*pos])
         return (NULL);
-    content = ft_substr(input, start, *pos - start);
+    content = ft_strndup(input + start, *pos - start);
     (*pos)++;
     return (content);
 }
@@ -328,13 +325,11 @@ void	process_quotes_in_arg(char **arg)
     if ((str[0] == '"' && str[len-1] == '"') ||
         (str[0] == '\'' && str[len-1] == '\''))
     {
-        fprintf(stderr, "DEBUG: Removing quotes from argument: '%s'\n", str);
         new_str = ft_substr(str, 1, len-2);
         if (new_str)
         {
             free(str); // Use free directly since we're handling str, not *arg
             *arg = new_str;
-            fprintf(stderr, "DEBUG: Quotes removed, new arg: '%s'\n", *arg);
         }
     }
 }
@@ -391,7 +386,7 @@ void	valid_quote_token(char *str, t_vars *vars, int *pos, int start)
     end_pos = *pos;
     if (scan_for_endquote(str, &end_pos, quote_char))
     {
-        token = ft_substr(str, start + 1, end_pos - start - 1);
+        token = ft_strndup(str + start + 1, end_pos - start - 1);
         if (token)
         {
             vars->curr_type = (quote_char == '"') 
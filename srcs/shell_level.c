@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/11 14:19:12 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/20 06:06:52 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 17:21:03 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,7 +14,8 @@
 
 /*
 Gets the shell level from environment variables.
-If SHLVL doesn't exist, creates it with value "1".
+If SHLVL doesn't exist, creates it with value "1" in the spare slot
+import_env() leaves at the end of the array.
 Stores the current SHLVL value in vars->shell_level.
 Return:
 - 0 on success.
@@ -66,7 +67,7 @@ int update_shlvl_env(char **env, int position, int new_level)
 	ft_safefree((void **)&new_shlvl);
 	if (!new_env_entry)
 		return (1);
-	ft_safefree((void **)&env[position]);
+	free_env_entry(env[position]);
 	env[position] = new_env_entry;
 	return (0);
 }
@@ -103,7 +104,6 @@ int incr_shell_level(t_vars *vars)
     i = 0;
     while (vars->env[i])
     {
-        fprintf(stderr, "DEBUG: Checking env entry %d: %s\n", i, vars->env[i]);
         if (ft_strncmp(vars->env[i], "SHLVL=", 6) == 0)
         {
             fprintf(stderr, "DEBUG: Found SHLVL at position %d\n", i);
@@ -21,64 +21,154 @@ Used by signal handlers to communicate signal reception to the main program.
 volatile sig_atomic_t	g_signal_received = 0;
 
 /*
-Sets up signal handlers for terminal control signals using sigaction.
-- Initialize sigaction structs for SIGINT (Ctrl+C) and SIGQUIT (Ctrl+\)
-- Assigns matching handler functions to each signal
-- Sets flags to 0 for standard behavior
-- Clears the signal masks to prevent blocking of other signals
-- Registers the handlers using sigaction() system call
-Sigaction() is more modern and portable than signal()
+Routes terminal and child signals to a signalfd instead of handlers.
+- Blocks SIGINT, SIGQUIT, SIGCHLD and SIGWINCH for the whole shell.
+- The blocked signals are read from vars->events.sigfd by the event
+  loop, so nothing runs in async signal context.
+- Readline is told not to install its own handlers.
+- SIGINT also gets a flag-only handler for the moments a builtin runs
+  with it unblocked, see builtin_interrupts().
+- If signalfd() or epoll_create1() fail, sigfd/epfd stay -1 and the
+  shell falls back to plain readline() with the signals blocked.
 Called during shell startup. Used with init_shell().
 */
-void	load_signals(void)
+void	load_signals(t_vars *vars)
 {
-	struct sigaction	sa_int;
-	struct sigaction	sa_quit;
+	t_events			*ev;
+	struct epoll_event	reg;
+	struct sigaction	sa;
 
-	ft_memset(&sa_int, 0, sizeof(sa_int));
-	ft_memset(&sa_quit, 0, sizeof(sa_quit));
-	sa_int.sa_handler = sigint_handler;
-	sa_int.sa_flags = 0;
-	sigemptyset(&sa_int.sa_mask);
-	sa_quit.sa_handler = sigquit_handler;
-	sa_quit.sa_flags = 0;
-	sigemptyset(&sa_quit.sa_mask);
-	sigaction(SIGINT, &sa_int, NULL);
-	sigaction(SIGQUIT, &sa_quit, NULL);
+	ev = &vars->events;
+	ft_memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = sigint_handler;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGINT, &sa, NULL);
+	sigemptyset(&ev->mask);
+	sigaddset(&ev->mask, SIGINT);
+	sigaddset(&ev->mask, SIGQUIT);
+	sigaddset(&ev->mask, SIGCHLD);
+	sigaddset(&ev->mask, SIGWINCH);
+	sigprocmask(SIG_BLOCK, &ev->mask, NULL);
+	rl_catch_signals = 0;
+	rl_catch_sigwinch = 0;
+	ev->sigfd = signalfd(-1, &ev->mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	ev->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (ev->sigfd < 0 || ev->epfd < 0)
+	{
+		cleanup_fds(ev->sigfd, ev->epfd);
+		ev->sigfd = -1;
+		ev->epfd = -1;
+		return ;
+	}
+	ft_memset(&reg, 0, sizeof(reg));
+	reg.events = EPOLLIN;
+	reg.data.fd = ev->sigfd;
+	epoll_ctl(ev->epfd, EPOLL_CTL_ADD, ev->sigfd, &reg);
+	reg.data.fd = STDIN_FILENO;
+	if (epoll_ctl(ev->epfd, EPOLL_CTL_ADD, STDIN_FILENO, &reg) == -1)
+	{
+		close(ev->epfd);
+		ev->epfd = -1;
+	}
 }
 
 /*
-Handles Ctrl+C (SIGINT) signal in interactive shell.
-- Writes a newline to move to a new prompt line
-- Uses readline utilities to:
-   - Tell readline that user is on a new line.
-   - Clear current input line with empty string.
-   - Redisplay the prompt with cleared input.
-- Sets g_signal_received to indicate interrupt occurred.
-This on-screen cancels the current input and shows a fresh
-prompt when Ctrl+C is pressed.
+Records a Ctrl+C that arrived while a builtin was running.
+- Only sets the flag; the builtin's blocking call fails with EINTR
+  and the next prompt starts on a fresh line.
 */
 void	sigint_handler(int sig)
 {
 	(void)sig;
 	g_signal_received = 1;
-	write(1, "\n", 1);
-	rl_on_new_line();
-	rl_replace_line("", 0);
-	rl_redisplay();
 }
 
 /*
-Handles Ctrl+\ (SIGQUIT) signal in interactive shell.
-- Uses readline utilities to:
-  - Tell readline that user is on a new line
-  - Redisplay the prompt with cleared input
-This custom Ctrl+\ doesn't terminate the process with a core dump.
-It does nothing else.
+Lets Ctrl+C interrupt a builtin running in the shell process.
+- on: Unblocks SIGINT, so blocking reads (cat, tee) get EINTR.
+- off: Blocks it again, routing it back to the signalfd.
+Works with exec_std_cmd() and exec_redirect_builtin().
 */
-void	sigquit_handler(int sig)
+void	builtin_interrupts(int on)
 {
-	(void)sig;
-	rl_on_new_line();
-	rl_redisplay();
+	sigset_t	mask;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGINT);
+	if (on)
+		sigprocmask(SIG_UNBLOCK, &mask, NULL);
+	else
+		sigprocmask(SIG_BLOCK, &mask, NULL);
+}
+
+/*
+Undoes the shell's signal mask in a freshly forked child.
+- Blocked signals stay blocked across execve(), so every child must
+  unblock them or Ctrl+C would never reach it.
+- Dispositions are left alone, so a background job's SIG_IGN stays.
+Works with every fork() site before exec or builtin execution.
+*/
+void	reset_child_signals(void)
+{
+	sigset_t	mask;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGINT);
+	sigaddset(&mask, SIGQUIT);
+	sigaddset(&mask, SIGCHLD);
+	sigaddset(&mask, SIGWINCH);
+	sigprocmask(SIG_UNBLOCK, &mask, NULL);
+}
+
+/*
+Drains every pending signal from the signalfd.
+- Never blocks: the signalfd is non-blocking.
+Returns:
+Bitmask of the signals read, (1 << signo) per signal.
+Works with event_readline(), wait_job() and poll_jobs().
+
+Example: Ctrl+C pressed while a job exited
+- Returns (1 << SIGINT) | (1 << SIGCHLD)
+*/
+int	read_signals(t_vars *vars)
+{
+	struct signalfd_siginfo	info;
+	int						got;
+
+	got = 0;
+	if (vars->events.sigfd < 0)
+		return (0);
+	while (read(vars->events.sigfd, &info, sizeof(info)) == sizeof(info))
+		got |= 1 << info.ssi_signo;
+	if (got & (1 << SIGINT))
+		g_signal_received = 1;
+	return (got);
+}
+
+/*
+Acts on signals that arrived while the shell was at a prompt.
+- SIGINT: Cancels the line being edited and shows a fresh prompt.
+- SIGQUIT: Ignored, like bash.
+- SIGCHLD: Reaps finished background jobs right away; they are
+  reported before the next prompt.
+- SIGWINCH: Lets readline pick up the new terminal size.
+Runs synchronously from the event loop, so calling readline here is
+safe (the old handlers did it from async signal context).
+Works with event_readline().
+*/
+void	handle_signals(t_vars *vars, int got)
+{
+	if (got & (1 << SIGINT))
+	{
+		write(STDOUT_FILENO, "\n", 1);
+		rl_on_new_line();
+		rl_replace_line("", 0);
+		rl_redisplay();
+		vars->error_code = 130;
+		g_signal_received = 0;
+	}
+	if (got & (1 << SIGCHLD))
+		poll_jobs(vars, 0);
+	if (got & (1 << SIGWINCH))
+		rl_resize_terminal();
 }
@@ -0,0 +1,122 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   speculate.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/26 10:12:40 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 19:41:03 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Parses a line the same way process_command() does, without running it.
+- Lexes with lex_line(), so an open quote never prompts for more.
+- Only a complete line is built: open quotes, a trailing pipe or a
+  syntax error give up (the real parse on Enter reports them).
+- Nothing on this path writes to stderr, which is the terminal the
+  user is typing on.
+- The token list is freed again, only the flat AST is kept.
+- An AST that does not compile is dropped, as in pcache_store().
+Returns:
+The flat AST (caller frees), or NULL if the line cannot be run as is.
+Works with spec_parse().
+*/
+t_flatast	*spec_build(char *line, int *background, t_vars *vars)
+{
+	t_flatast	*flat;
+	t_program	*prog;
+
+	flat = NULL;
+	cleanup_token_list(vars);
+	lex_line(line, vars);
+	if (vars->head && syntax_status(vars) == SYNTAX_COMPLETE)
+	{
+		*background = detach_bg_token(vars, 0);
+		if (*background >= 0)
+			vars->astroot = build_ast(vars);
+		if (*background >= 0 && vars->astroot)
+			flat = flatten_ast(vars->astroot);
+	}
+	cleanup_token_list(vars);
+	vars->quote_depth = 0;
+	if (!flat)
+		return (NULL);
+	prog = compile_ast(flat);
+	if (!prog)
+	{
+		free(flat);
+		return (NULL);
+	}
+	free_program(prog);
+	return (flat);
+}
+
+/*
+Parses the line being typed while the keyboard is idle.
+- Called by event_readline() after SPEC_IDLE_MS without a keystroke.
+- Keyed on the buffer text: nothing is done if this exact text is
+  already in the parse cache or was the last line parsed ahead.
+- The result waits in cache->spec. Half typed lines never take a
+  cache slot, only the line actually entered does (spec_take()).
+- Lines the cache refuses (containing '$') are skipped.
+- The shell's exit status is left as it was.
+Works with event_readline().
+
+Example: Typing "ls -l | wc -l", pausing, then pressing Enter
+- The pause: "ls -l | wc -l" is lexed, built and flattened
+- Enter: run_cached_cmd() finds it in cache->spec and runs it
+*/
+void	spec_parse(char *line, t_vars *vars)
+{
+	t_pcentry	*spec;
+	t_flatast	*flat;
+	int			background;
+	int			status;
+
+	spec = &vars->pcache.spec;
+	if (!pcache_cacheable(line)
+		|| (spec->line && ft_strcmp(spec->line, line) == 0)
+		|| pcache_find(&vars->pcache, line, pcache_hash(line)))
+		return ;
+	status = vars->error_code;
+	background = 0;
+	flat = spec_build(line, &background, vars);
+	vars->error_code = status;
+	pcache_free_entry(spec);
+	if (!flat)
+		return ;
+	spec->line = ft_strdup(line);
+	if (!spec->line)
+	{
+		free(flat);
+		return ;
+	}
+	spec->hash = pcache_hash(line);
+	spec->ast = flat;
+	spec->background = background;
+}
+
+/*
+Moves the line parsed ahead into the cache if it is the line entered.
+- Takes a slot like any new entry (LRU eviction if full).
+Returns:
+The new cache entry, or NULL if the entered line is something else.
+Works with run_cached_cmd().
+*/
+t_pcentry	*spec_take(t_pcache *cache, char *line, unsigned long hash)
+{
+	t_pcentry	*entry;
+
+	if (!cache->spec.line || cache->spec.hash != hash
+		|| ft_strcmp(cache->spec.line, line) != 0)
+		return (NULL);
+	entry = pcache_slot(cache);
+	*entry = cache->spec;
+	ft_memset(&cache->spec, 0, sizeof(t_pcentry));
+	cache->spec_hits++;
+	return (entry);
+}
@@ -6,7 +6,7 @@
 /*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/02 06:12:16 by bleow             #+#    #+#             */
-/*   Updated: 2025/03/21 09:07:50 by bleow            ###   ########.fr       */
+/*   Updated: 2025/03/26 19:41:03 by bleow            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -161,12 +161,8 @@ void maketoken(char *token, t_vars *vars)
 	if (!token)
 		return;
 		
-	fprintf(stderr, "DEBUG: maketoken called with token='%s', type=%d\n", 
-			token, vars->curr_type);
-			
 	if (vars->curr_type == TYPE_CMD)
 	{
-		fprintf(stderr, "DEBUG: Command token processed: '%s'\n", token);
 		node = make_cmdnode(token);
 		if (!node)
 			return;
@@ -175,14 +171,11 @@ void maketoken(char *token, t_vars *vars)
 	else if (vars->curr_type == TYPE_STRING && vars->current && 
 			 vars->current->type == TYPE_CMD)
 	{
-		fprintf(stderr, "DEBUG: Converting string '%s' to argument for command '%s'\n", 
-				token, vars->current->args[0]);
 		append_arg(vars->current, token);
 		return;  /* Return early since we're just modifying the existing node */
 	}
 	else
 	{
-		fprintf(stderr, "DEBUG: Other token processed: '%s', type=%d\n", token, vars->curr_type);
 		node = initnode(vars->curr_type, token);
 		if (!node)
 			return;
@@ -190,22 +183,6 @@ void maketoken(char *token, t_vars *vars)
 	}
 }
 
-// Helper function to find the last command node
-t_node *find_last_command(t_node *head)
-{
-	t_node *current = head;
-	t_node *last_cmd = NULL;
-	
-	while (current)
-	{
-		if (current->type == TYPE_CMD)
-			last_cmd = current;
-		current = current->next;
-	}
-	
-	return last_cmd;
-}
-
 /*
 Determines if variable expansion is allowed in current context.
 - Returns 1 if no quotes or in double quotes.
@@ -563,17 +540,12 @@ void	handle_quote_token(char *str, t_vars *vars, int *pos)
 			vars->curr_type = TYPE_DOUBLE_QUOTE;
 		else
 			vars->curr_type = TYPE_SINGLE_QUOTE;
-		fprintf(stderr, "DEBUG: Found balanced quotes: '%.*s'\n", 
-				*pos - start, str + start);
 		maketoken(str, vars);
 		vars->start = *pos;
 	}
 	else
 	{
-		vars->quote_depth++;
-		vars->quote_ctx[vars->quote_depth - 1].type = quote_char;
-		fprintf(stderr, "DEBUG: Unclosed %s quote found (depth: %d)\n",
-				(quote_char == '"' ? "double" : "single"), vars->quote_depth);
+		push_quote(vars, quote_char);
 	}
 }
 
@@ -740,16 +712,12 @@ void process_other_token(char *token, t_vars *vars)
 {
 	t_node *node = NULL;
 	
-	fprintf(stderr, "DEBUG: process_other_token called with token='%s', type=%d\n", 
-			token, vars->curr_type);
-			
 	if (!token || !vars)
 		return;
 	
 	// For pipe tokens, ensure proper type is set
 	if (strcmp(token, "|") == 0)
 	{
-		fprintf(stderr, "DEBUG: Forcing pipe token type to TYPE_PIPE\n");
 		vars->curr_type = TYPE_PIPE;
 	}
 	
@@ -757,7 +725,6 @@ void process_other_token(char *token, t_vars *vars)
 	node = new_other_node(token, vars->curr_type);
 	if (!node)
 	{
-		fprintf(stderr, "DEBUG: Failed to create node for token '%s'\n", token);
 		return;
 	}
 	
@@ -766,19 +733,13 @@ void process_other_token(char *token, t_vars *vars)
 	{
 		vars->head = node;
 		vars->current = node;
-		fprintf(stderr, "DEBUG: Set head token: type=%d, value='%s'\n", 
-				node->type, token);
 	}
 	else
 	{
 		vars->current->next = node;
 		node->prev = vars->current;
 		vars->current = node;
-		fprintf(stderr, "DEBUG: Added token to list: type=%d, value='%s'\n", 
-				node->type, token);
 	}
-	
-	fprintf(stderr, "DEBUG: Other token node created: type=%d\n", node->type);
 }
 
 /*
@@ -823,13 +784,11 @@ t_node	*make_cmdnode(char *token)
 {
 	t_node	*node;
 
-	fprintf(stderr, "DEBUG: [make_cmdnode] Creating command node for '%s'\n", token);
 	node = initnode(TYPE_CMD, token);
 	if (!node)
 		return (NULL);
 	if (node->args)
 	{
-		fprintf(stderr, "DEBUG: [make_cmdnode] Cleaning up existing args\n");
 		if (node->args[0])
 			ft_safefree((void **)&node->args[0]);
 		ft_safefree((void **)&node->args);
@@ -837,20 +796,17 @@ t_node	*make_cmdnode(char *token)
 	node->args = malloc(sizeof(char *) * 2);
 	if (!node->args)
 	{
-		fprintf(stderr, "DEBUG: [make_cmdnode] Failed to allocate args array\n");
 		ft_safefree((void **)&node);
 		return (NULL);
 	}
 	node->args[0] = ft_strdup(token);
 	if (!node->args[0])
 	{
-		fprintf(stderr, "DEBUG: [make_cmdnode] Failed to duplicate token\n");
 		ft_safefree((void **)&node->args);
 		ft_safefree((void **)&node);
 		return (NULL);
 	}
 	node->args[1] = NULL;
-	fprintf(stderr, "DEBUG: [make_cmdnode] Successfully created command node\n");
 	return (node);
 }
 
@@ -910,6 +866,7 @@ Updates the token list with a new node.
 - Handles first token as head.
 - Otherwise adds to end of list.
 - Updates current pointer.
+- Feeds the token to the syntax validator.
 Works with process_cmd_token() and process_other_token().
 
 Example: When adding command node
@@ -930,6 +887,7 @@ void build_token_linklist(t_vars *vars, t_node *node)
 		node->prev = vars->current;
 		vars->current = node;
 	}
+	syntax_step(vars, node->type);
 }
 
 /*
@@ -55,8 +55,7 @@ void	handle_quote_token(char *str, t_vars *vars, int *pos)
 		valid_quote_token(str, vars, pos, start);
 	else
 	{
-		vars->quote_depth++;
-		vars->quote_ctx[vars->quote_depth - 1].type = quote_char;
+		push_quote(vars, quote_char);
 	}
 }
 
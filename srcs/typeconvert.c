@@ -35,6 +35,8 @@ const char *get_token_str_basic(t_tokentype type)
         return (TOKEN_TYPE_PIPE);
 	else if (type == TYPE_EXPANSION)
 		return (TOKEN_TYPE_EXPANSION);
+	else if (type == TYPE_BACKGROUND)
+		return (TOKEN_TYPE_BACKGROUND);
     return (TOKEN_TYPE_NULL);
 }
 
@@ -116,6 +118,8 @@ t_tokentype get_token_type(const char *str)
 		return (TYPE_PIPE);
 	else if (ft_strcmp(str, TOKEN_TYPE_EXIT_STATUS) == 0)
 		return (TYPE_EXIT_STATUS);
+	else if (ft_strcmp(str, TOKEN_TYPE_BACKGROUND) == 0)
+		return (TYPE_BACKGROUND);
 	else
 		return (TYPE_STRING);
 }
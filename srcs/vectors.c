@@ -0,0 +1,131 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   vectors.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/25 19:05:41 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/25 21:02:37 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Makes sure a vector has room for need elements of size bytes.
+- Capacity doubles (starting at VEC_MIN) until need fits, so n pushes
+  cost O(n) copying in total.
+- On failure the old block is kept and stays valid.
+Returns:
+1 on success, 0 on allocation failure.
+Works with push_cmd_node(), push_quote() and collect_stages().
+
+Example: cap = 16, need = 17
+- New block of 32 elements, 16 old ones copied over, cap = 32
+*/
+int	vec_reserve(void **items, int *cap, int need, size_t size)
+{
+	void	*grown;
+	int		new_cap;
+
+	if (need <= *cap)
+		return (1);
+	new_cap = *cap * 2;
+	if (new_cap < VEC_MIN)
+		new_cap = VEC_MIN;
+	while (new_cap < need)
+		new_cap *= 2;
+	grown = malloc(size * new_cap);
+	if (!grown)
+		return (0);
+	if (*items && *cap)
+		ft_memcpy(grown, *items, size * *cap);
+	free(*items);
+	*items = grown;
+	*cap = new_cap;
+	return (1);
+}
+
+/*
+Appends a command node to vars->cmd_nodes.
+Returns:
+1 on success, 0 on allocation failure.
+Works with get_cmd_nodes().
+*/
+int	push_cmd_node(t_vars *vars, t_node *node)
+{
+	if (!vec_reserve((void **)&vars->cmd_nodes, &vars->cmd_cap,
+			vars->cmd_count + 1, sizeof(t_node *)))
+		return (0);
+	vars->cmd_nodes[vars->cmd_count++] = node;
+	return (1);
+}
+
+/*
+Opens a quote context of the given type on vars->quote_ctx.
+- quote_depth is only raised once the slot exists.
+Returns:
+1 on success, 0 on allocation failure.
+Works with the lexer when it meets an unclosed quote.
+
+Example: For input 'echo "abc
+- quote_ctx[0].type = '"', quote_depth = 1
+*/
+int	push_quote(t_vars *vars, char type)
+{
+	if (!vec_reserve((void **)&vars->quote_ctx, &vars->quote_cap,
+			vars->quote_depth + 1, sizeof(t_quote_context)))
+		return (0);
+	vars->quote_ctx[vars->quote_depth].type = type;
+	vars->quote_ctx[vars->quote_depth].start_pos = vars->pos;
+	vars->quote_ctx[vars->quote_depth].depth = vars->quote_depth;
+	vars->quote_depth++;
+	return (1);
+}
+
+/*
+Appends one input line to a growable command line buffer.
+- sep goes in front of the line when text already holds something
+  ('\n' for quote continuations, ' ' for pipe continuations).
+- Capacity doubles, so a long continuation is copied once per doubling
+  rather than once per line.
+Returns:
+- 1 on success.
+- 0 on allocation failure (text keeps its old contents).
+Works with lexerlist(), lex_open_quotes() and handle_unfinished_pipes().
+
+Example: text "ls |", sep ' ', line "wc -l"
+- text becomes "ls | wc -l" without rebuilding "ls |"
+*/
+int	linebuf_add(t_linebuf *text, char sep, char *line)
+{
+	int	len;
+
+	len = ft_strlen(line);
+	if (!vec_reserve((void **)&text->data, &text->cap,
+			text->len + len + 2, sizeof(char)))
+		return (0);
+	if (sep && text->len > 0)
+		text->data[text->len++] = sep;
+	ft_memcpy(text->data + text->len, line, len);
+	text->len += len;
+	text->data[text->len] = '\0';
+	return (1);
+}
+
+/*
+Frees the parser vectors held in vars.
+Works with cleanup_vars().
+*/
+void	free_vectors(t_vars *vars)
+{
+	free(vars->cmd_nodes);
+	vars->cmd_nodes = NULL;
+	vars->cmd_count = 0;
+	vars->cmd_cap = 0;
+	free(vars->quote_ctx);
+	vars->quote_ctx = NULL;
+	vars->quote_depth = 0;
+	vars->quote_cap = 0;
+}
@@ -0,0 +1,349 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   vm.c                                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/25 14:12:47 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/26 19:02:14 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Finishes the current stage and moves on to the next one.
+- Drops the expanded words (the arena is reused by the next
+  expansion) and releases the fd plan.
+- Closes the input pipe and the write end of the output pipe, which
+  now belong to the children.
+- The read end of the output pipe becomes the next stage's input.
+Works with vm_spawn(), vm_run_builtin() and vm_run().
+*/
+void	vm_end_stage(t_vm *vm)
+{
+	vm->argv = NULL;
+	close_fdplan(&vm->plan);
+	vm->plan.count = 0;
+	if (vm->in_fd >= 0)
+		close(vm->in_fd);
+	if (vm->pipefd[1] >= 0)
+		close(vm->pipefd[1]);
+	vm->in_fd = vm->pipefd[0];
+	vm->pipefd[0] = -1;
+	vm->pipefd[1] = -1;
+}
+
+/*
+Opens the current stage's fd plan into a builtin I/O context.
+- Same rules as open_builtin_redir(): later redirections of the same
+  stream replace earlier ones, buffered output is flushed first.
+- Heredoc descriptors move from the plan into io.
+Returns:
+1 on success, 0 if a file could not be opened (error reported).
+Works with vm_run_builtin().
+*/
+int	vm_open_plan(t_vm *vm, t_io *io, t_vars *vars)
+{
+	t_fdop	*op;
+	int		fd;
+	int		i;
+
+	i = 0;
+	while (i < vm->plan.count)
+	{
+		op = &vm->plan.ops[i++];
+		fd = op->fd;
+		op->fd = -1;
+		if (op->path)
+			fd = open(op->path, op->flags | O_CLOEXEC, 0644);
+		if (fd == -1)
+		{
+			redirect_error(op->path, vars, 1);
+			return (0);
+		}
+		if (op->target == STDOUT_FILENO)
+		{
+			io_flush(io);
+			cleanup_fds(-1, io->out);
+			io->out = fd;
+		}
+		else
+		{
+			cleanup_fds(io->in, -1);
+			io->in = fd;
+		}
+	}
+	return (1);
+}
+
+/*
+Turns the current process into the current stage.
+- Applies the fd plan, then runs a builtin and exits with its status,
+  or replaces the process with the external command.
+- A stage without a command (only redirections) exits with 0.
+- A builtin child drops the shell's flag-only SIGINT handler, so
+  Ctrl+C kills it like any other command (SIG_IGN is kept).
+Returns:
+Never returns.
+Works with vm_spawn(), in a child or in place of the shell.
+*/
+void	vm_exec(t_vm *vm, char *path, t_vars *vars)
+{
+	t_io	io;
+	int		result;
+
+	if (!apply_fdplan(&vm->plan, vars))
+		exit(1);
+	if (!vm->argv || !vm->argv[0])
+		exit(0);
+	if (!path)
+	{
+		if (signal(SIGINT, SIG_DFL) == SIG_IGN)
+			signal(SIGINT, SIG_IGN);
+		init_io(&io, STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO);
+		result = execute_builtin(vm->argv[0], vm->argv, vars, &io);
+		io_flush(&io);
+		exit(result);
+	}
+	execve(path, vm->argv, vars->env);
+	perror("bleshell");
+	exit(126);
+}
+
+/*
+Runs the current stage in a child process.
+- External commands are looked up in the shell first, so a missing
+  command is reported without forking (status 127).
+- A lone final command of a batch run replaces the shell instead,
+  if the program is the whole command line (vars->flat).
+- The child joins the job's process group and wires its pipe ends.
+Returns:
+1 to continue the program.
+Works with vm_step() and vm_run_builtin().
+
+Example: Stage 2 of "ls | grep x | wc"
+- in_fd = read end of pipe 1, pipefd = pipe 2
+- Child: stdin <- pipe 1, stdout -> pipe 2, execve("/usr/bin/grep")
+- Shell: closes its copies, pipe 2's read end becomes in_fd
+*/
+int	vm_spawn(t_vm *vm, t_vars *vars)
+{
+	char	*path;
+
+	path = NULL;
+	vm->last_pid = -1;
+	vm->status = 0;
+	if (vm->argv && vm->argv[0] && !is_builtin(vm->argv[0]))
+	{
+		path = get_cmd_path(vm->argv[0], vars->env, vars);
+		if (!path)
+		{
+			ft_putstr_fd("bleshell: command not found: ", 2);
+			ft_putendl_fd(vm->argv[0], 2);
+			vm->status = 127;
+			return (vm_end_stage(vm), 1);
+		}
+		if (vm->prog->stages == 1 && vm->prog->ast == vars->flat
+			&& can_replace_shell(vars))
+		{
+			reset_child_signals();
+			vm_exec(vm, path, vars);
+		}
+	}
+	vm->last_pid = fork();
+	if (vm->last_pid == 0)
+	{
+		join_job_pgrp(vars, 1);
+		reset_child_signals();
+		if (vm->in_fd >= 0)
+			dup2(vm->in_fd, STDIN_FILENO);
+		if (vm->pipefd[1] >= 0)
+			dup2(vm->pipefd[1], STDOUT_FILENO);
+		cleanup_fds(vm->in_fd, vm->pipefd[1]);
+		cleanup_fds(vm->pipefd[0], -1);
+		vm_exec(vm, path, vars);
+	}
+	if (vm->last_pid < 0)
+	{
+		perror("bleshell: fork");
+		vm->status = 1;
+	}
+	else
+		vm->pids[vm->npids++] = vm->last_pid;
+	track_job_pgrp(vars, vm->last_pid, 1);
+	ft_safefree((void **)&path);
+	vm_end_stage(vm);
+	return (1);
+}
+
+/*
+Runs the current stage inside the shell.
+- Used for lone builtins and for builtins ending a pipeline that only
+  write output. Redirections are opened into an I/O context, the
+  shell's own descriptors are never touched.
+- The previous stage's pipe is closed first: the builtin does not
+  read it, and the writer gets SIGPIPE instead of blocking.
+- If the expanded name turns out not to be a builtin, the stage is
+  spawned instead.
+Returns:
+1 to continue the program.
+Works with vm_step().
+
+Example: "echo $HOME > out"
+- EXPAND gives {"echo", "/home/bleow"}
+- out is opened as io.out, echo writes it with one write()
+*/
+int	vm_run_builtin(t_vm *vm, t_vars *vars)
+{
+	t_io	io;
+
+	if (vm->argv && vm->argv[0] && !is_builtin(vm->argv[0]))
+		return (vm_spawn(vm, vars));
+	cleanup_fds(vm->in_fd, -1);
+	vm->in_fd = -1;
+	init_io(&io, STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO);
+	vm->status = 0;
+	if (!vm_open_plan(vm, &io, vars))
+		vm->status = 1;
+	else if (vm->argv && vm->argv[0])
+	{
+		builtin_interrupts(1);
+		vm->status = execute_builtin(vm->argv[0], vm->argv, vars, &io);
+		builtin_interrupts(0);
+		io_flush(&io);
+	}
+	cleanup_fds(io.in, io.out);
+	vm->last_pid = -1;
+	vm_end_stage(vm);
+	return (1);
+}
+
+/*
+Waits for every stage the program spawned.
+- The exit status of the command line is that of the last stage,
+  whether it ran in a child or in the shell.
+- With job control the shell also wakes when a stage is stopped
+  (Ctrl+Z). The stages still running go to the job table together.
+Returns:
+Exit status, also stored in vars->error_code.
+Works with vm_step() and vm_run().
+*/
+int	vm_wait(t_vm *vm, t_vars *vars)
+{
+	int	options;
+	int	status;
+	int	stop;
+	int	stopped;
+	int	i;
+
+	vars->error_code = vm->status;
+	options = 0;
+	if (vars->job_control && !vars->subshell)
+		options = WUNTRACED;
+	stop = 0;
+	stopped = 0;
+	i = -1;
+	while (++i < vm->npids)
+	{
+		if (waitpid(vm->pids[i], &status, options) != vm->pids[i])
+			continue ;
+		if (WIFSTOPPED(status))
+		{
+			stop = status;
+			stopped++;
+		}
+		else if (vm->pids[i] == vm->last_pid && vm->last_pid > 0)
+			handle_cmd_status(status, vars);
+	}
+	vm->npids = 0;
+	if (stopped)
+		stop_job(vars, vm->last_pid, stopped, stop);
+	return (vars->error_code);
+}
+
+/*
+Executes one instruction.
+Returns:
+1 to continue, 0 to abort the program (heredoc interrupted, bad
+redirection, no memory, no pipe).
+Works with vm_run().
+*/
+int	vm_step(t_vm *vm, t_insn *insn, t_vars *vars)
+{
+	t_flatast	*ast;
+	int			target;
+
+	ast = vm->prog->ast;
+	if (insn->op == OP_REDIR)
+	{
+		target = ast->right[insn->node];
+		return (target >= 0 && ast->arg_count[target]
+			&& add_fdop(&vm->plan, ast->type[insn->node],
+				ast->argv[ast->arg_start[target]], vars));
+	}
+	if (insn->op == OP_EXPAND)
+	{
+		vm->argv = expand_words(&ast->words[ast->arg_start[insn->node]],
+				&vm->arena, vars);
+		return (vm->argv != NULL);
+	}
+	if (insn->op == OP_PIPE)
+		return (setup_pipe(vm->pipefd, vars));
+	if (insn->op == OP_SPAWN)
+		return (vm_spawn(vm, vars));
+	if (insn->op == OP_RUN_BUILTIN)
+		return (vm_run_builtin(vm, vars));
+	if (insn->op == OP_WAIT)
+		vm_wait(vm, vars);
+	return (1);
+}
+
+/*
+Runs a compiled command line.
+- Fetches and executes instructions in order, one pass, no branches.
+- On abort the open stage is torn down, stages already running are
+  still waited for, and the status is 1.
+- Every argv lives in one arena, freed once the program is done.
+- The pid table is sized from the program, one slot per stage.
+Returns:
+Exit status of the command line.
+Works with run_flat().
+*/
+int	vm_run(t_program *prog, t_vars *vars)
+{
+	t_vm	vm;
+	int		pc;
+
+	vm.pids = malloc(sizeof(pid_t) * (prog->stages + 1));
+	if (!vm.pids)
+		return (vars->error_code = 1, 1);
+	vm.prog = prog;
+	arena_init(&vm.arena);
+	vm.argv = NULL;
+	vm.plan.count = 0;
+	vm.in_fd = -1;
+	vm.pipefd[0] = -1;
+	vm.pipefd[1] = -1;
+	vm.npids = 0;
+	vm.last_pid = -1;
+	vm.status = 0;
+	pc = 0;
+	while (pc < prog->len)
+	{
+		if (!vm_step(&vm, &prog->code[pc], vars))
+		{
+			vm_end_stage(&vm);
+			vm_end_stage(&vm);
+			vm.last_pid = -1;
+			vm.status = 1;
+			vm_wait(&vm, vars);
+			break ;
+		}
+		pc++;
+	}
+	arena_free(&vm.arena);
+	free(vm.pids);
+	return (vars->error_code);
+}
@@ -0,0 +1,263 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   words.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: bleow <bleow@student.42kl.edu.my>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/25 18:02:40 by bleow             #+#    #+#             */
+/*   Updated: 2025/03/25 18:02:40 by bleow            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../includes/minishell.h"
+
+/*
+Counts the segments a word splits into.
+- Each $ reference is one segment, as is each run of text between.
+- Same rules as handle_expansion(): the name after '$' is the
+  longest run of letters, digits and '_', possibly empty.
+Returns:
+Number of segments (0 for an empty word).
+Works with build_words().
+*/
+int	count_word_segs(char *word)
+{
+	int	count;
+	int	i;
+
+	count = 0;
+	i = 0;
+	while (word[i])
+	{
+		count++;
+		if (word[i++] == '$')
+			while (ft_isalnum(word[i]) || word[i] == '_')
+				i++;
+		else
+			while (word[i] && word[i] != '$')
+				i++;
+	}
+	return (count);
+}
+
+/*
+Splits a word into its template segments.
+Returns:
+Number of segments written to segs.
+Works with build_words().
+
+Example: "$HOME/src"
+- segs[0] = {var, "HOME"}, segs[1] = {text, "/src"}
+*/
+int	split_word(char *word, t_wseg *segs)
+{
+	int	count;
+	int	i;
+
+	count = 0;
+	i = 0;
+	while (word[i])
+	{
+		segs[count].var = (word[i] == '$');
+		i += segs[count].var;
+		segs[count].text = word + i;
+		if (segs[count].var)
+			while (ft_isalnum(word[i]) || word[i] == '_')
+				i++;
+		else
+			while (word[i] && word[i] != '$')
+				i++;
+		segs[count].len = (int)(word + i - segs[count].text);
+		count++;
+	}
+	return (count);
+}
+
+/*
+Builds the templates for a command's parsed words.
+- One allocation: the word array, then every segment.
+- Segments point into args, so args must outlive the templates.
+Returns:
+Word array ending with an entry whose segs is NULL, or NULL on
+allocation failure.
+Works with prepare_words().
+*/
+t_word	*build_words(char **args)
+{
+	t_word	*words;
+	t_wseg	*segs;
+	size_t	nargs;
+	size_t	nsegs;
+	size_t	i;
+
+	nargs = ft_arrlen(args);
+	nsegs = 0;
+	i = 0;
+	while (i < nargs)
+		nsegs += count_word_segs(args[i++]);
+	words = malloc(sizeof(t_word) * (nargs + 1) + sizeof(t_wseg) * nsegs);
+	if (!words)
+		return (NULL);
+	segs = (t_wseg *)(words + nargs + 1);
+	i = 0;
+	while (i < nargs)
+	{
+		words[i].segs = segs;
+		words[i].count = split_word(args[i], segs);
+		segs += words[i].count;
+		i++;
+	}
+	words[nargs].segs = NULL;
+	words[nargs].count = 0;
+	return (words);
+}
+
+/*
+Pre-splits every command word of an AST into templates.
+- Done on first use, so each later execution only has to fill in
+  variable values. Nodes that already have templates are skipped.
+- Flat ASTs get their templates from flatten_ast() instead.
+Works with expand_argv().
+*/
+void	prepare_words(t_node *node)
+{
+	if (!node)
+		return ;
+	if (node->type == TYPE_CMD && node->args && !node->words)
+		node->words = build_words(node->args);
+	prepare_words(node->left);
+	prepare_words(node->right);
+}
+
+/*
+Looks up the text a segment stands for, without copying it.
+- Literal segments are their own text.
+- $0 is the shell name, a bare '$' is empty, anything else comes
+  from the environment (empty if unset).
+Returns:
+Pointer to the value (length in *len); never NULL.
+Works with argv_size() and expand_argv().
+*/
+char	*seg_value(t_wseg *seg, t_vars *vars, size_t *len)
+{
+	int	i;
+
+	*len = seg->len;
+	if (!seg->var)
+		return (seg->text);
+	*len = 0;
+	if (seg->len == 1 && seg->text[0] == '0')
+	{
+		*len = 8;
+		return ("bleshell");
+	}
+	i = 0;
+	while (seg->len && vars->env && vars->env[i])
+	{
+		if (!ft_strncmp(vars->env[i], seg->text, seg->len)
+			&& vars->env[i][seg->len] == '=')
+		{
+			*len = ft_strlen(vars->env[i] + seg->len + 1);
+			return (vars->env[i] + seg->len + 1);
+		}
+		i++;
+	}
+	return ("");
+}
+
+/*
+Computes the arena space one expansion of a command needs.
+- The argv pointer array plus every expanded word and its '\0',
+  each rounded up to arena_alloc()'s alignment.
+Returns:
+Size in bytes.
+Works with expand_argv().
+*/
+size_t	argv_size(t_word *words, t_vars *vars)
+{
+	size_t	size;
+	size_t	word;
+	size_t	len;
+	int		i;
+	int		j;
+
+	size = 0;
+	i = 0;
+	while (words[i].segs)
+	{
+		word = 1;
+		j = 0;
+		while (j < words[i].count)
+		{
+			seg_value(&words[i].segs[j++], vars, &len);
+			word += len;
+		}
+		size += (word + 7) & ~(size_t)7;
+		i++;
+	}
+	return (size + ((sizeof(char *) * (i + 1) + 7) & ~(size_t)7));
+}
+
+/*
+Expands a word array into a fresh argv in the arena.
+- The templates are never touched, so the same words expand
+  correctly on every run (loops, cached ASTs).
+- The arena is emptied first: the previous argv from it is gone.
+- One pass sizes the result, a second copies; no other allocation.
+Returns:
+NULL-terminated argv inside the arena, or NULL on allocation failure.
+Works with expand_argv() and vm_step().
+
+Example: words of {"ls", "$HOME/src"} with HOME=/home/bleow
+- Returns {"ls", "/home/bleow/src", NULL}
+*/
+char	**expand_words(t_word *words, t_arena *arena, t_vars *vars)
+{
+	char	**argv;
+	char	*value;
+	size_t	start;
+	size_t	len;
+	int		i;
+	int		j;
+
+	if (!arena_reserve(arena, argv_size(words, vars)))
+		return (NULL);
+	i = 0;
+	while (words[i].segs)
+		i++;
+	argv = arena_alloc(arena, sizeof(char *) * (i + 1));
+	i = -1;
+	while (words[++i].segs)
+	{
+		start = arena->used;
+		argv[i] = arena->buf + start;
+		j = 0;
+		while (j < words[i].count)
+		{
+			value = seg_value(&words[i].segs[j++], vars, &len);
+			ft_memcpy(arena->buf + arena->used, value, len);
+			arena->used += len;
+		}
+		arena->buf[arena->used] = '\0';
+		arena->used = start + ((arena->used - start + 8) & ~(size_t)7);
+	}
+	argv[i] = NULL;
+	return (argv);
+}
+
+/*
+Expands a command node's words into a fresh argv in the arena.
+- Templates are split on first use and kept on the node; the parsed
+  args are never touched.
+Returns:
+NULL-terminated argv inside the arena, or NULL on allocation failure.
+Works with the tree-walking executors.
+*/
+char	**expand_argv(t_node *node, t_arena *arena, t_vars *vars)
+{
+	prepare_words(node);
+	if (!node->words)
+		return (NULL);
+	return (expand_words(node->words, arena, vars));
+}